@@ -34,23 +34,22 @@
 #include "Keyer.h"
 
 #define DIGITAL_PIN_DEBOUNCE_INTERVAL 10
-#define SIDETONE_FREQUENCY 880.0
 #define WPM_RESOLUTION 1200000
 
-Keyer::Keyer(KeyerConfig &config, AD9833 &toneGen)
-    : config(config), toneGen(toneGen), wpm(20), currentState(IDLE)
+Keyer::Keyer(KeyerConfig &config, SidetoneGenerator &toneGen)
+    : config(config), toneGen(toneGen), pttReadyTime(0), pttTimerStarted(false), wpm(20),
+      farnsworthWPM(0), outputKeyed(false)
 {
   debouncerDah = Bounce2::Button();
   debouncerDit = Bounce2::Button();
   config.pttHangTime *= 1000;
+  config.pttLeadTime *= 1000;
 }
 
 void Keyer::setup()
 {
   updateTiming();
 
-  SPI.begin();
-  
   pinMode(config.wpmSpeedPin, INPUT);
 
   pinMode(config.ditPin, INPUT_PULLUP);
@@ -69,16 +68,19 @@ void Keyer::setup()
   debouncerDit.interval(DIGITAL_PIN_DEBOUNCE_INTERVAL);
   debouncerDah.interval(DIGITAL_PIN_DEBOUNCE_INTERVAL);
 
+#ifdef PWM_SIDETONE
+  toneGen.begin(SIDETONE_FREQUENCY);
+#else
+  SPI.begin();
   toneGen.begin();
   toneGen.setWave(AD9833_OFF);
   toneGen.setFrequency(SIDETONE_FREQUENCY, 0);
   toneGen.setFrequencyChannel(0);
-
+#endif
 }
 
 void Keyer::update()
 {
-  updateWPM();
   currentTime = micros();
   
   debouncerDit.update();
@@ -86,87 +88,27 @@ void Keyer::update()
 
   bool ditState = !debouncerDit.read();
   bool dahState = !debouncerDah.read();
-  bool iambicState = ditState && dahState;
 
-  switch (currentState)
+  // Hold the paddles back until PTT has settled. This covers a translator
+  // space that ends with a paddle held, not only keying from IDLE.
+  if ((ditState || dahState) && !isTransmitReady())
   {
-  case IDLE:
-    if (iambicState)
-    {
-      sendDit(); // Start with a dit in iambic mode
-      currentState = IAMBIC_DIT;
-    }
-    else if (ditState)
-    {
-      sendDit();
-      currentState = TRANSMITTING_DIT;
-    }
-    else if (dahState)
-    {
-      sendDah();
-      currentState = TRANSMITTING_DAH;
-    }
-    break;
-
-  case IAMBIC_DIT:
-  case IAMBIC_DAH:
-    if (currentTime >= transmissionEndTime)
-    {
-      toggleOutput(false);  // Ensure output is off before next element
-      if (iambicState)      // Check if still in iambic mode
-      { 
-        previousState = currentState;
-        waitingEndTime = currentTime + elementSpace; // Setup waiting end time
-      }
-      currentState = WAITING_ELEMENT_SPACE; // Wait for element space
-    }
-    break;
-
-  case WAITING_ELEMENT_SPACE:
-    if (currentTime >= waitingEndTime)
-    {
-      if (iambicState)
-      {
-        if (previousState == IAMBIC_DIT)
-        {
-          currentState = IAMBIC_DAH;
-          sendDah();
-        }
-        else
-        {
-          currentState = IAMBIC_DIT;
-          sendDit();
-        }
-      }
-      else
-      {
-        currentState = IDLE;
-      }
-    }
-    break;
-
-  case TRANSMITTING_DIT:
-  case TRANSMITTING_DAH:
-    if (currentTime >= transmissionEndTime)
-    {
-      toggleOutput(false);
-      currentState = WAITING_ELEMENT_SPACE;
-      waitingEndTime = currentTime + elementSpace;
-    }
-    break;
-
-  case WAITING_CHARACTER_SPACE:
-  case WAITING_WORD_SPACE:
-    if (currentTime >= waitingEndTime)
-    {
-      currentState = IDLE; // Transition back to IDLE after the space period
-    }
-    break;
+    beginTransmission();
+    ditState = dahState = false;
+  }
 
-  default:
-    break;
+  // Only run the core at edges: a paddle change or a due deadline
+  unsigned long wakeTime;
+  if (ditState != core.getDit() || dahState != core.getDah())
+  {
+    core.handle({KE_PADDLES, currentTime, ditState, dahState});
+  }
+  else if (core.getNextWakeTime(wakeTime) && (long)(currentTime - wakeTime) >= 0)
+  {
+    core.handle({KE_TIMER, currentTime, ditState, dahState});
   }
 
+  applyOutput();
   checkEndTransmission();
 }
 
@@ -179,6 +121,7 @@ void Keyer::beginTransmission()
 
   digitalWrite(config.pttPin, HIGH); // Assert PTT HIGH on transmission start
   transmissionStartTime = currentTime;
+  pttReadyTime = currentTime + config.pttLeadTime;
   pttTimerStarted = true;
 
 #ifdef DEBUG_OUTPUT
@@ -192,9 +135,8 @@ void Keyer::checkEndTransmission()
   if (
       pttTimerStarted &&
       isReadyForInput() &&
-      (currentTime > transmissionStartTime) &&
-      (currentTime >= lastKeyEndTime + config.pttHangTime) &&
-      (currentTime >= waitingEndTime + config.pttHangTime))
+      (long)(currentTime - transmissionStartTime) > 0 &&
+      (long)(currentTime - getPttDropTime(currentTime)) >= 0)
   {
     digitalWrite(config.pttPin, LOW); // Turn off PTT after hang time
     pttTimerStarted = false;          // Reset flag
@@ -203,23 +145,24 @@ void Keyer::checkEndTransmission()
     float pttTime = (currentTime - transmissionStartTime) / 1000000.0;
     sprintf(strBuffer, "PTT: OFF (%.2fs)", pttTime);
     Serial.println(strBuffer);
+#ifdef PWM_SIDETONE
+    sprintf(strBuffer, "Sidetone ISR: max %u cycles, %lu over budget",
+            toneGen.getMaxIsrCycles(), toneGen.getIsrOverruns());
+    Serial.println(strBuffer);
+#endif
 #endif
 
   }
 }
 
-void Keyer::sendDit()
-{
-  toggleOutput(true);
-  transmissionEndTime = micros() + ditDuration;
-  lastKeyEndTime = transmissionEndTime;
-}
-
-void Keyer::sendDah()
+/// @brief follows the core's key state on the output pins
+void Keyer::applyOutput()
 {
-  toggleOutput(true);
-  transmissionEndTime = micros() + dahDuration;
-  lastKeyEndTime = transmissionEndTime;
+  if (core.isKeyed() != outputKeyed)
+  {
+    outputKeyed = core.isKeyed();
+    toggleOutput(outputKeyed);
+  }
 }
 
 void Keyer::toggleOutput(bool state)
@@ -230,7 +173,11 @@ void Keyer::toggleOutput(bool state)
   }
   digitalWrite(config.ledPin, state ? HIGH : LOW);
   digitalWrite(config.outputPin, state ? HIGH : LOW);
+#ifdef PWM_SIDETONE
+  toneGen.key(state); // Envelope ramps in the ISR, no hard switch
+#else
   toneGen.setWave(state ? AD9833_SINE : AD9833_OFF);
+#endif
 }
 
 // these are approximate values for testing, a more robust "fist" can be achieved with some more work.
@@ -248,6 +195,8 @@ void Keyer::updateTiming()
     characterSpace = static_cast<int>(3 * ditDuration * farnsworthFactor);
     wordSpace = static_cast<int>((7 * ditDuration) * (1.2f - 0.02f * farnsworthWPM));
 
+    core.setTiming(ditDuration, dahDuration, elementSpace, characterSpace, wordSpace);
+
 #ifdef DEBUG_OUTPUT
     sprintf(strBuffer, "WPM=%d, Farnsworth Factor=%.2f, Char Space=%d, Word Space=%d",
             wpm, farnsworthFactor, characterSpace, wordSpace);
@@ -258,7 +207,74 @@ void Keyer::updateTiming()
 /// @brief returns true when keyer is ready for input (in IDLE state)
 bool Keyer::isReadyForInput() const
 {
-  return currentState == IDLE; // Only consider ready if truly idle, not just between symbols
+  return core.isIdle(); // Only consider ready if truly idle, not just between symbols
+}
+
+/// @brief returns the current state of the keying state machine
+KeyerState Keyer::getState() const
+{
+  return core.getState();
+}
+
+/// @brief gets the micros() time of the next timed transition (element end, space end,
+/// PTT settle or PTT drop). Returns false when nothing is pending and only paddles can wake it.
+bool Keyer::getNextEventTime(unsigned long &eventTime) const
+{
+  if (core.getNextWakeTime(eventTime))
+  {
+    return true;
+  }
+  if (!pttTimerStarted)
+  {
+    return false;
+  }
+  if ((long)(micros() - pttReadyTime) < 0)
+  {
+    eventTime = pttReadyTime; // Still in PTT lead time
+    return true;
+  }
+  eventTime = getPttDropTime(micros());
+  return true;
+}
+
+/// @brief gets the micros() time PTT drops: the hang time after PTT settled or after the
+/// core's last transition, whichever is later. Call only while PTT is up.
+unsigned long Keyer::getPttDropTime(unsigned long now) const
+{
+  // A transition from before this transmission is stale. If the paddles never reached
+  // the core it can be old enough to look like the future in a signed compare, so it
+  // counts only if its age is no more than the transmission's.
+  unsigned long lastActivity = pttReadyTime;
+  unsigned long lastTransition = core.getLastTransitionTime();
+  if (now - lastTransition <= now - transmissionStartTime && (long)(lastTransition - pttReadyTime) > 0)
+  {
+    lastActivity = lastTransition;
+  }
+  return lastActivity + config.pttHangTime;
+}
+
+/// @brief asserts PTT ahead of keying so the lead time runs before the first element
+void Keyer::requestTransmission()
+{
+  currentTime = micros();
+  beginTransmission();
+}
+
+/// @brief returns true once PTT is asserted and its lead time has elapsed
+bool Keyer::isTransmitReady() const
+{
+  return pttTimerStarted && (long)(micros() - pttReadyTime) >= 0; // Safe across micros() wrap
+}
+
+/// @brief passes a translator request to the core and applies the result
+bool Keyer::sendRequest(KeyerEventType type)
+{
+  if (!core.handle({type, micros(), core.getDit(), core.getDah()}))
+  {
+    return false;
+  }
+  applyOutput();
+  return true;
 }
 
 /// @brief Call only when keyer is ready for input (IDLE state)
@@ -268,11 +284,8 @@ bool Keyer::sendCharacterSpace()
   {
     return false;
   }
-  beginTransmission();
-  toggleOutput(false); // Ensure the output is off
-  currentState = WAITING_CHARACTER_SPACE;
-  waitingEndTime = micros() + characterSpace;
-  return true;
+  requestTransmission();
+  return sendRequest(KE_REQUEST_CHARACTER_SPACE);
 }
 
 /// @brief Call only when keyer is ready for input (IDLE state)
@@ -282,11 +295,8 @@ bool Keyer::sendWordSpace()
   {
     return false;
   }
-  beginTransmission();
-  toggleOutput(false); // Ensure the output is off
-  currentState = WAITING_WORD_SPACE;
-  waitingEndTime = micros() + wordSpace;
-  return true;
+  requestTransmission();
+  return sendRequest(KE_REQUEST_WORD_SPACE);
 }
 
 /// @brief starts sending a dit. Call only when keyer is ready for input (IDLE state)
@@ -296,9 +306,12 @@ bool Keyer::triggerDit()
   {
     return false;
   }
-  sendDit();
-  currentState = TRANSMITTING_DIT; // Update state appropriately
-  return true;
+  requestTransmission();
+  if (!isTransmitReady())
+  {
+    return false; // PTT still settling, caller retries
+  }
+  return sendRequest(KE_REQUEST_DIT);
 }
 
 /// @brief starts sending a dah. Call only when keyer is ready for input (IDLE state)
@@ -308,9 +321,12 @@ bool Keyer::triggerDah()
   {
     return false;
   }
-  sendDah();
-  currentState = TRANSMITTING_DAH;
-  return true;
+  requestTransmission();
+  if (!isTransmitReady())
+  {
+    return false; // PTT still settling, caller retries
+  }
+  return sendRequest(KE_REQUEST_DAH);
 }
 
 void Keyer::setWPM(int newWpm)
@@ -325,6 +341,8 @@ int Keyer::getWPM() const
   return wpm;
 }
 
+/// @brief samples the speed pot and applies the averaged WPM. Not called from update(),
+/// the ADC read is slow so the sketch runs it as a background task.
 void Keyer::updateWPM()
 {
   static int readings[NUM_READINGS]; // Array to store readings
@@ -9,6 +9,8 @@
  *     iambic keying and straight key use. It includes debounce logic
  *     for key presses and can be configured for different words per
  *     minute (WPM) speeds, including Farnsworth timing adjustments.
+ *     Keying decisions are made by KeyerCore; this class reads the
+ *     paddles, sequences PTT and drives the output pins and sidetone.
  *
  * Usage:
  *     Compile with Arduino compiler and upload to an Arduino board.
@@ -21,6 +23,7 @@
  *     Timer library for managing timing events.
  *     MD_AD9833 library for generating audio tone outputs via SPI.
  *     SPI library for communication.
+ *     PwmSidetone replaces the AD9833 when PWM_SIDETONE is defined.
  *
  * Revisions:
  *     1.0 - Initial release.
@@ -35,28 +38,24 @@
 #define Keyer_h
 
 #include <Arduino.h>
-#include <AD9833.h>
 #include <Bounce2.h>
+#include "KeyerCore.h"
 
 //#define DEBUG_OUTPUT 1
+//#define PWM_SIDETONE 1 // built-in DDS sidetone on D11 instead of the AD9833
 
-#define SIDETONE_FREQUENCY 1000
+#ifdef PWM_SIDETONE
+#include "PwmSidetone.h"
+typedef PwmSidetone SidetoneGenerator;
+#else
+#include <AD9833.h>
+typedef AD9833 SidetoneGenerator;
+#endif
+
+#define SIDETONE_FREQUENCY 880.0 // Hz, AD9833 or PWM sidetone
 #define INVERT_WPM true   // allows for idiots (like me) that wire the pot backwards
 #define NUM_READINGS 10   // Number of samples for debouncing wpm pot
 
-// Define the states of the state machine
-enum KeyerState
-{
-    IDLE,
-    TRANSMITTING_DIT,
-    TRANSMITTING_DAH,
-    WAITING_ELEMENT_SPACE,
-    IAMBIC_DIT,
-    IAMBIC_DAH,
-    WAITING_CHARACTER_SPACE,
-    WAITING_WORD_SPACE
-};
-
 struct KeyerConfig
 {
     int ditPin;
@@ -64,14 +63,15 @@ struct KeyerConfig
     int outputPin;
     int pttPin;
     int ledPin;
-    int pttHangTime;
+    int pttHangTime;   // PTT tail after the last element (ms)
     int wpmSpeedPin;
+    int pttLeadTime;   // PTT settle time before the first element (ms)
 };
 
 class Keyer
 {
 public:
-    Keyer(KeyerConfig &config, AD9833 &toneGen);
+    Keyer(KeyerConfig &config, SidetoneGenerator &toneGen);
     void setup();
     void update();
     bool sendCharacterSpace();
@@ -81,18 +81,23 @@ public:
     bool triggerDah();
     bool triggerDit();
     bool isReadyForInput() const;
+    void requestTransmission();
+    bool isTransmitReady() const;
+    KeyerState getState() const;
+    bool getNextEventTime(unsigned long &eventTime) const;
+    void updateWPM();
 
 private:
     KeyerConfig &config;
-    AD9833 &toneGen;
+    SidetoneGenerator &toneGen;
     Bounce2::Button debouncerDit;
     Bounce2::Button debouncerDah;
 
+    KeyerCore core; // Hardware-free state machine, this class adds pins and PTT
+
     unsigned long currentTime;
     unsigned long transmissionStartTime;
-    unsigned long transmissionEndTime;
-    unsigned long lastKeyEndTime;
-    unsigned long waitingEndTime;
+    unsigned long pttReadyTime;
     unsigned long ditDuration;
     unsigned long dahDuration;
     unsigned long elementSpace;
@@ -107,17 +112,15 @@ private:
     int wpm;           // Words per minute for Morse code transmission
     int farnsworthWPM; // Adjusted WPM for Farnsworth timing
 
-    KeyerState currentState; // Current state of the state machine
-    KeyerState previousState;
+    bool outputKeyed;
 
-    void sendDit();
-    void sendDah();
+    bool sendRequest(KeyerEventType type);
+    void applyOutput();
     void toggleOutput(bool state);
     void updateTiming();
-    void handleIambicKeying();
     void beginTransmission();
     void checkEndTransmission();
-    void updateWPM();
+    unsigned long getPttDropTime(unsigned long now) const;
 };
 
 #endif
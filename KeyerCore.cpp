@@ -0,0 +1,149 @@
+/***********************************************************************
+ * File: KeyerCore.cpp
+ * Author: Dan Quigley, N7HQ
+ * Date: October 2026
+ *
+ * Description:
+ *     Transition table and event handling for KeyerCore.
+ *
+ * Notes:
+ *     Each table entry packs the next state (low nibble) and an action
+ *     (high nibble) into one byte, 108 bytes in PROGMEM. Columns 0-7
+ *     are (expired << 2 | dah << 1 | dit), columns 8-11 are requests.
+ *     Paddles are sampled when a deadline expires, so changes during an
+ *     element or space only matter at its end.
+ ***********************************************************************/
+
+#include "KeyerCore.h"
+
+enum KeyerAction : uint8_t
+{
+    KA_NONE,            // stay, nothing changes
+    KA_REJECT,          // request refused, not idle
+    KA_KEY_DIT,         // key down for a dit
+    KA_KEY_DAH,         // key down for a dah
+    KA_ELEMENT_SPACE,   // key up for an element space
+    KA_CHARACTER_SPACE, // key up for a character space
+    KA_WORD_SPACE,      // key up for a word space
+    KA_IDLE             // key up, no deadline
+};
+
+#define COLUMN_EXPIRED 4
+#define COLUMN_REQUEST 8
+#define COLUMN_COUNT 12
+
+static constexpr uint8_t T(KeyerCoreState next, KeyerAction action)
+{
+    return (uint8_t)next | ((uint8_t)action << 4);
+}
+
+// Paddle columns: none, dit, dah, both
+#define FROM_IDLE T(CS_IDLE, KA_NONE), T(CS_DIT, KA_KEY_DIT), T(CS_DAH, KA_KEY_DAH), T(CS_IAMBIC_DIT, KA_KEY_DIT)
+#define AFTER_SPACE T(CS_IDLE, KA_IDLE), T(CS_DIT, KA_KEY_DIT), T(CS_DAH, KA_KEY_DAH), T(CS_IAMBIC_DIT, KA_KEY_DIT)
+#define HOLD(s) T(s, KA_NONE), T(s, KA_NONE), T(s, KA_NONE), T(s, KA_NONE)
+#define REJECT(s) T(s, KA_REJECT), T(s, KA_REJECT), T(s, KA_REJECT), T(s, KA_REJECT)
+#define REQUESTS T(CS_DIT, KA_KEY_DIT), T(CS_DAH, KA_KEY_DAH), T(CS_CHARACTER_SPACE, KA_CHARACTER_SPACE), T(CS_WORD_SPACE, KA_WORD_SPACE)
+
+static constexpr uint8_t transitionTable[CS_COUNT][COLUMN_COUNT] PROGMEM = {
+    // CS_IDLE: no deadline, paddles key at once
+    {FROM_IDLE, FROM_IDLE, REQUESTS},
+    // CS_DIT / CS_DAH: element ends into an element space
+    {HOLD(CS_DIT), T(CS_SPACE_AFTER_DIT, KA_ELEMENT_SPACE), T(CS_SPACE_AFTER_DIT, KA_ELEMENT_SPACE),
+     T(CS_SPACE_AFTER_DIT, KA_ELEMENT_SPACE), T(CS_SPACE_AFTER_DIT, KA_ELEMENT_SPACE), REJECT(CS_DIT)},
+    {HOLD(CS_DAH), T(CS_SPACE_AFTER_DAH, KA_ELEMENT_SPACE), T(CS_SPACE_AFTER_DAH, KA_ELEMENT_SPACE),
+     T(CS_SPACE_AFTER_DAH, KA_ELEMENT_SPACE), T(CS_SPACE_AFTER_DAH, KA_ELEMENT_SPACE), REJECT(CS_DAH)},
+    // CS_IAMBIC_DIT / CS_IAMBIC_DAH: same, both paddles were held when keyed
+    {HOLD(CS_IAMBIC_DIT), T(CS_SPACE_AFTER_DIT, KA_ELEMENT_SPACE), T(CS_SPACE_AFTER_DIT, KA_ELEMENT_SPACE),
+     T(CS_SPACE_AFTER_DIT, KA_ELEMENT_SPACE), T(CS_SPACE_AFTER_DIT, KA_ELEMENT_SPACE), REJECT(CS_IAMBIC_DIT)},
+    {HOLD(CS_IAMBIC_DAH), T(CS_SPACE_AFTER_DAH, KA_ELEMENT_SPACE), T(CS_SPACE_AFTER_DAH, KA_ELEMENT_SPACE),
+     T(CS_SPACE_AFTER_DAH, KA_ELEMENT_SPACE), T(CS_SPACE_AFTER_DAH, KA_ELEMENT_SPACE), REJECT(CS_IAMBIC_DAH)},
+    // CS_SPACE_AFTER_DIT / CS_SPACE_AFTER_DAH: held paddle repeats, squeeze alternates
+    {HOLD(CS_SPACE_AFTER_DIT), T(CS_IDLE, KA_IDLE), T(CS_DIT, KA_KEY_DIT), T(CS_DAH, KA_KEY_DAH),
+     T(CS_IAMBIC_DAH, KA_KEY_DAH), REJECT(CS_SPACE_AFTER_DIT)},
+    {HOLD(CS_SPACE_AFTER_DAH), T(CS_IDLE, KA_IDLE), T(CS_DIT, KA_KEY_DIT), T(CS_DAH, KA_KEY_DAH),
+     T(CS_IAMBIC_DIT, KA_KEY_DIT), REJECT(CS_SPACE_AFTER_DAH)},
+    // CS_CHARACTER_SPACE / CS_WORD_SPACE: end like idle, paddles key at once
+    {HOLD(CS_CHARACTER_SPACE), AFTER_SPACE, REJECT(CS_CHARACTER_SPACE)},
+    {HOLD(CS_WORD_SPACE), AFTER_SPACE, REJECT(CS_WORD_SPACE)},
+};
+
+// Coarse state reported for each internal state
+static constexpr uint8_t publicState[CS_COUNT] PROGMEM = {
+    IDLE, TRANSMITTING_DIT, TRANSMITTING_DAH, IAMBIC_DIT, IAMBIC_DAH,
+    WAITING_ELEMENT_SPACE, WAITING_ELEMENT_SPACE, WAITING_CHARACTER_SPACE, WAITING_WORD_SPACE};
+
+KeyerCore::KeyerCore()
+    : state(CS_IDLE), keyed(false), dit(false), dah(false), hasDeadline(false),
+      deadline(0), lastTransitionTime(0)
+{
+    setTiming(1, 3, 1, 3, 7);
+}
+
+void KeyerCore::setTiming(unsigned long ditDuration, unsigned long dahDuration, unsigned long elementSpace,
+                          unsigned long characterSpace, unsigned long wordSpace)
+{
+    durations[KD_DIT] = ditDuration;
+    durations[KD_DAH] = dahDuration;
+    durations[KD_ELEMENT_SPACE] = elementSpace;
+    durations[KD_CHARACTER_SPACE] = characterSpace;
+    durations[KD_WORD_SPACE] = wordSpace;
+}
+
+/// @brief applies one event, returns false if a request was refused
+bool KeyerCore::handle(const KeyerEvent &event)
+{
+    advance(event.time); // Deadlines that passed first, with the paddles as they were
+
+    switch (event.type)
+    {
+    case KE_PADDLES:
+        dit = event.dit;
+        dah = event.dah;
+        return apply((dah << 1) | dit, event.time);
+
+    case KE_TIMER:
+        return true;
+
+    default:
+        return apply(COLUMN_REQUEST + (event.type - KE_REQUEST_DIT), event.time);
+    }
+}
+
+/// @brief gets the time of the next timed transition, false when only an event can wake the core
+bool KeyerCore::getNextWakeTime(unsigned long &wakeTime) const
+{
+    wakeTime = deadline;
+    return hasDeadline;
+}
+
+KeyerState KeyerCore::getState() const
+{
+    return (KeyerState)pgm_read_byte(&publicState[state]);
+}
+
+// Replays every expired deadline up to time, each from the one before it
+void KeyerCore::advance(unsigned long time)
+{
+    while (hasDeadline && (long)(time - deadline) >= 0)
+    {
+        apply(COLUMN_EXPIRED | (dah << 1) | dit, deadline);
+    }
+}
+
+bool KeyerCore::apply(uint8_t column, unsigned long baseTime)
+{
+    uint8_t entry = pgm_read_byte(&transitionTable[state][column]);
+    uint8_t action = entry >> 4;
+    state = (KeyerCoreState)(entry & 0x0F);
+
+    if (action <= KA_REJECT)
+    {
+        return action == KA_NONE;
+    }
+
+    keyed = action <= KA_KEY_DAH;
+    hasDeadline = action != KA_IDLE;
+    deadline = baseTime + durations[min(action - KA_KEY_DIT, KD_COUNT - 1)];
+    lastTransitionTime = baseTime;
+    return true;
+}
@@ -0,0 +1,119 @@
+/***********************************************************************
+ * File: KeyerCore.h
+ * Author: Dan Quigley, N7HQ
+ * Date: October 2026
+ *
+ * Description:
+ *     Hardware-free keyer state machine. Driven only by timestamped
+ *     events (paddle edges, timer expiry, translator requests) through
+ *     a constexpr transition table, it decides when the key goes up or
+ *     down and computes the next wake-up time directly. Deadlines are
+ *     chained from the previous deadline rather than from when the
+ *     event was handled, so element timing does not depend on how often
+ *     or how late the caller runs it.
+ *
+ * Usage:
+ *     core.setTiming(...);
+ *     core.handle({KE_PADDLES, micros(), dit, dah});     // on paddle edges
+ *     if (core.getNextWakeTime(t) && now >= t)
+ *         core.handle({KE_TIMER, now, false, false});     // on expiry
+ *     core.isKeyed();                                     // drive output
+ *
+ * Revisions:
+ *     1.0 - Initial release.
+ ***********************************************************************/
+
+#ifndef KeyerCore_h
+#define KeyerCore_h
+
+#include <Arduino.h>
+
+// Coarse keyer states, as reported by Keyer::getState()
+enum KeyerState
+{
+    IDLE,
+    TRANSMITTING_DIT,
+    TRANSMITTING_DAH,
+    WAITING_ELEMENT_SPACE,
+    IAMBIC_DIT,
+    IAMBIC_DAH,
+    WAITING_CHARACTER_SPACE,
+    WAITING_WORD_SPACE
+};
+
+// Internal states: the element space remembers which element preceded
+// it so the table alone decides what to alternate to in iambic mode
+enum KeyerCoreState : uint8_t
+{
+    CS_IDLE,
+    CS_DIT,
+    CS_DAH,
+    CS_IAMBIC_DIT,
+    CS_IAMBIC_DAH,
+    CS_SPACE_AFTER_DIT,
+    CS_SPACE_AFTER_DAH,
+    CS_CHARACTER_SPACE,
+    CS_WORD_SPACE,
+    CS_COUNT
+};
+
+enum KeyerEventType : uint8_t
+{
+    KE_PADDLES,                 // paddle state changed (dit/dah fields)
+    KE_TIMER,                   // wake-up time reached
+    KE_REQUEST_DIT,             // translator requests, accepted only when idle
+    KE_REQUEST_DAH,
+    KE_REQUEST_CHARACTER_SPACE,
+    KE_REQUEST_WORD_SPACE
+};
+
+struct KeyerEvent
+{
+    KeyerEventType type;
+    unsigned long time; // micros()
+    bool dit;
+    bool dah;
+};
+
+// Durations indexed in the same order as the scheduling actions
+enum KeyerDuration : uint8_t
+{
+    KD_DIT,
+    KD_DAH,
+    KD_ELEMENT_SPACE,
+    KD_CHARACTER_SPACE,
+    KD_WORD_SPACE,
+    KD_COUNT
+};
+
+class KeyerCore
+{
+public:
+    KeyerCore();
+    void setTiming(unsigned long dit, unsigned long dah, unsigned long elementSpace,
+                   unsigned long characterSpace, unsigned long wordSpace);
+    bool handle(const KeyerEvent &event);
+    bool getNextWakeTime(unsigned long &wakeTime) const;
+    bool isKeyed() const { return keyed; }
+    bool isIdle() const { return state == CS_IDLE; }
+    bool getDit() const { return dit; }
+    bool getDah() const { return dah; }
+    KeyerCoreState getCoreState() const { return state; }
+    KeyerState getState() const;
+    unsigned long getLastTransitionTime() const { return lastTransitionTime; }
+
+private:
+    KeyerCoreState state;
+    bool keyed;
+    bool dit;
+    bool dah;
+    bool hasDeadline;
+    unsigned long deadline;
+    unsigned long lastTransitionTime;
+    unsigned long durations[KD_COUNT];
+
+    bool apply(uint8_t column, unsigned long baseTime);
+    void advance(unsigned long time);
+};
+
+#endif
@@ -0,0 +1,155 @@
+/***********************************************************************
+ * File: LoopScheduler.cpp
+ * Author: Dan Quigley, N7HQ
+ * Date: October 2026
+ *
+ * Description:
+ *     Implements LoopScheduler. Each pass runs the keying task, then at
+ *     most one background task: the most overdue one whose budget fits
+ *     before the keyer's next edge. The keyer is checked again before
+ *     anything else runs.
+ ***********************************************************************/
+
+#include "LoopScheduler.h"
+
+static void clearStats(LoopTask &task)
+{
+  task.runs = 0;
+  task.overruns = 0;
+  task.maxRunTime = 0;
+  task.totalRunTime = 0;
+  task.maxLateness = 0;
+}
+
+LoopScheduler::LoopScheduler(Keyer &keyer) : keyer(keyer), taskCount(0)
+{
+  keyingTask.name = "keying";
+  keyingTask.run = nullptr;
+  keyingTask.period = 0;
+  keyingTask.budget = 0;
+  keyingTask.nextRun = 0;
+  clearStats(keyingTask);
+}
+
+void LoopScheduler::setKeyingTask(TaskFunction run, unsigned long budgetUs)
+{
+  keyingTask.run = run;
+  keyingTask.budget = budgetUs;
+}
+
+/// @brief registers a background task, returns false when the task table is full
+bool LoopScheduler::addTask(const char *name, TaskFunction run, unsigned long periodUs, unsigned long budgetUs)
+{
+  if (taskCount >= SCHEDULER_MAX_TASKS)
+  {
+    return false;
+  }
+
+  LoopTask &task = tasks[taskCount++];
+  task.name = name;
+  task.run = run;
+  task.period = periodUs;
+  task.budget = budgetUs;
+  task.nextRun = micros();
+  clearStats(task);
+  return true;
+}
+
+/// @brief one scheduling pass, call from loop()
+void LoopScheduler::run()
+{
+  unsigned long now = micros();
+
+  // The keying task runs every pass. Its lateness is measured against the
+  // keyer's pending edge, so it only grows when an edge was served late.
+  if (keyingTask.run)
+  {
+    unsigned long edge;
+    bool edgeDue = keyer.getNextEventTime(edge) && (long)(now - edge) >= 0;
+    runTask(keyingTask, edgeDue ? edge : now);
+    now = micros();
+  }
+
+  // Pick the most overdue background task that fits in the slack
+  LoopTask *next = nullptr;
+  for (uint8_t i = 0; i < taskCount; i++)
+  {
+    LoopTask &task = tasks[i];
+    if ((long)(now - task.nextRun) < 0 || !hasSlack(task, now))
+    {
+      continue;
+    }
+    if (!next || (long)(task.nextRun - next->nextRun) < 0)
+    {
+      next = &task;
+    }
+  }
+
+  if (next)
+  {
+    unsigned long dueTime = next->nextRun;
+    next->nextRun += next->period;
+    if ((long)(now - next->nextRun) >= 0)
+    {
+      next->nextRun = now + next->period; // Fell a whole period behind, do not burst
+    }
+    runTask(*next, dueTime);
+  }
+}
+
+bool LoopScheduler::hasSlack(const LoopTask &task, unsigned long now) const
+{
+  unsigned long edge;
+  if (!keyer.getNextEventTime(edge))
+  {
+    return true; // Nothing timed pending, only a paddle press can need the keyer
+  }
+  return (long)(edge - now) >= (long)(task.budget + SCHEDULER_GUARD_TIME);
+}
+
+void LoopScheduler::runTask(LoopTask &task, unsigned long dueTime)
+{
+  unsigned long start = micros();
+  task.run();
+  unsigned long elapsed = micros() - start;
+
+  unsigned long lateness = (long)(start - dueTime) > 0 ? start - dueTime : 0;
+  task.runs++;
+  task.totalRunTime += elapsed;
+  if (elapsed > task.maxRunTime)
+  {
+    task.maxRunTime = elapsed;
+  }
+  if (elapsed > task.budget)
+  {
+    task.overruns++;
+  }
+  if (lateness > task.maxLateness)
+  {
+    task.maxLateness = lateness;
+  }
+}
+
+uint8_t LoopScheduler::getTaskCount() const
+{
+  return taskCount;
+}
+
+const LoopTask &LoopScheduler::getTask(uint8_t index) const
+{
+  return tasks[index];
+}
+
+const LoopTask &LoopScheduler::getKeyingTask() const
+{
+  return keyingTask;
+}
+
+void LoopScheduler::resetStats()
+{
+  clearStats(keyingTask);
+  for (uint8_t i = 0; i < taskCount; i++)
+  {
+    clearStats(tasks[i]);
+  }
+}
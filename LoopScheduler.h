@@ -0,0 +1,74 @@
+/***********************************************************************
+ * File: LoopScheduler.h
+ * Author: Dan Quigley, N7HQ
+ * Date: October 2026
+ *
+ * Description:
+ *     Deadline-aware cooperative scheduler for the main loop. The keying
+ *     task (keyer + translator) runs on every pass and owns the keyer's
+ *     next edge. Background tasks (serial input, the speed pot, debug
+ *     output) each have a period and a run-time budget, and are started
+ *     only when that budget fits in the slack before the next edge.
+ *
+ * Usage:
+ *     scheduler.setKeyingTask(keyingTask, budgetUs);
+ *     scheduler.addTask("serial", serialTask, periodUs, budgetUs);
+ *     ...
+ *     void loop() { scheduler.run(); }
+ *
+ * Notes:
+ *     Tasks are never preempted. A task that runs past its budget is
+ *     counted in overruns, and can still delay an edge by the excess.
+ *
+ * Revisions:
+ *     1.0 - Initial release.
+ ***********************************************************************/
+
+#ifndef LoopScheduler_h
+#define LoopScheduler_h
+
+#include <Arduino.h>
+#include "Keyer.h"
+
+#define SCHEDULER_MAX_TASKS 6
+#define SCHEDULER_GUARD_TIME 50 // us of margin kept in front of every edge
+
+typedef void (*TaskFunction)();
+
+struct LoopTask
+{
+    const char *name;
+    TaskFunction run;
+    unsigned long period;       // us between runs, 0 for every pass
+    unsigned long budget;       // us the task is allowed per run
+    unsigned long nextRun;      // micros() when the task is next due
+    unsigned long runs;
+    unsigned long overruns;     // runs that took longer than budget
+    unsigned long maxRunTime;   // us
+    unsigned long totalRunTime; // us
+    unsigned long maxLateness;  // us between due time and start
+};
+
+class LoopScheduler
+{
+public:
+    LoopScheduler(Keyer &keyer);
+    void setKeyingTask(TaskFunction run, unsigned long budgetUs);
+    bool addTask(const char *name, TaskFunction run, unsigned long periodUs, unsigned long budgetUs);
+    void run();
+    uint8_t getTaskCount() const;
+    const LoopTask &getTask(uint8_t index) const;
+    const LoopTask &getKeyingTask() const;
+    void resetStats();
+
+private:
+    Keyer &keyer;
+    LoopTask keyingTask;
+    LoopTask tasks[SCHEDULER_MAX_TASKS];
+    uint8_t taskCount;
+
+    bool hasSlack(const LoopTask &task, unsigned long now) const;
+    void runTask(LoopTask &task, unsigned long dueTime);
+};
+
+#endif
@@ -15,6 +15,7 @@
  *
  * Dependencies:
  *     - Keyer.h: Handles the physical Morse code keying.
+ *     - MorseInputNormalizer.h: Decodes and normalizes incoming text.
  *
  * Revisions:
  *     1.0 - Initial release.
@@ -88,17 +89,34 @@ const MorseCodeMapping MorseCodeTranslator::morseMap[] = {
     {"..--.", '^'},
     {".--.-", '_'},
     {"....-", '`'},
-    {".-.-", 'Ä'},
-    {".--.-", 'Á'},
-    {"..-..", 'É'},
-    {"--.--", 'Ñ'},
-    {"---.", 'Ö'},
-    {"..--", 'Ü'},
-    {"..._._", '<'}};
+    {".-.-", '\xC4'},  // Ä
+    {".--.-", '\xC1'}, // Á
+    {"..-..", '\xC9'}, // É
+    {"--.--", '\xD1'}, // Ñ
+    {"---.", '\xD6'},  // Ö
+    {"..--", '\xDC'}}; // Ü
 
 const int MorseCodeTranslator::morseMapSize = sizeof(morseMap) / sizeof(morseMap[0]);
 
-void MorseCodeTranslator::setText(const String &text)
+// Prosigns are sent as one run of elements with no character space inside
+const ProsignMapping MorseCodeTranslator::prosignMap[] = {
+    {"AR", ".-.-."},
+    {"AS", ".-..."},
+    {"BK", "-...-.-"},
+    {"BT", "-...-"},
+    {"CL", "-.-..-.."},
+    {"CT", "-.-.-"},
+    {"HH", "........"},
+    {"KN", "-.--."},
+    {"SK", "...-.-"},
+    {"SN", "...-."},
+    {"SOS", "...---..."}};
+
+const int MorseCodeTranslator::prosignMapSize = sizeof(prosignMap) / sizeof(prosignMap[0]);
+
+/// @brief queues a whole line. Returns false if busy, or if the line did not fit in
+/// the queue, in which case only the part that fit is sent.
+bool MorseCodeTranslator::setText(const String &text)
 {
     if (isSending)
     {
@@ -107,111 +125,182 @@ void MorseCodeTranslator::setText(const String &text)
         Serial.println(F("Currently sending, cannot accept a new line."));
 #endif        
 
-        return;
+        return false;
+    }
+
+    normalizer.reset();
+    unsigned int written = 0;
+    while (written < text.length() && write(text[written]))
+    {
+        written++;
+    }
+    bool complete = written == text.length() && write('\n');
+
+    if (!complete)
+    {
+
+#ifdef DEBUG_OUTPUT
+        Serial.println(F("Line too long for the send queue, truncated."));
+#endif
+
     }
 
-    textToTranslate = text;
-    textToTranslate.toUpperCase();
-    if (textToTranslate.length() == 0)
+    if (!isSending)
     {
 
 #ifdef DEBUG_OUTPUT
         Serial.println(F("Nothing to send."));
 #endif        
-        return;
+        return complete;
     }
 
-    isSending = true;
-    currentCharIndex = 0;
-    symbolIndex = 0;
-    currentState = TS_IDLE;
-
 #ifdef DEBUG_OUTPUT
     Serial.print(F("Sending: "));
-    Serial.println(textToTranslate);
+    Serial.println(text);
 #endif
 
+    return complete;
+}
+
+/// @brief streams one input byte into the send queue, returns 0 if the queue is full
+size_t MorseCodeTranslator::write(uint8_t byte)
+{
+    if (availableForWrite() == 0)
+    {
+        return 0;
+    }
+
+    uint8_t tokens[MORSE_MAX_TOKENS_PER_BYTE];
+    uint8_t count = normalizer.push(byte, tokens);
+    if (count == 0)
+    {
+        return 1;
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        tokenQueue[(queueHead + queueCount) % TRANSLATOR_QUEUE_SIZE] = tokens[i];
+        queueCount++;
+    }
+
+    if (!isSending)
+    {
+        isSending = true;
+        symbolIndex = 0;
+        currentState = TS_IDLE;
+
+        // Look ahead: raise PTT now so its lead time overlaps the translator
+        // spinning up instead of delaying the first element
+        keyer.requestTransmission();
+    }
+    return 1;
+}
+
+/// @brief returns how many more bytes write() is guaranteed to accept
+int MorseCodeTranslator::availableForWrite() const
+{
+    // Letters held for a possible prosign still need their queue slots
+    return TRANSLATOR_QUEUE_SIZE - queueCount - normalizer.getPendingTokens();
 }
 
 void MorseCodeTranslator::update()
 {
-    if (textToTranslate.length() == 0)
+    // Take every step that does not wait on the keyer, so the next element is
+    // keyed in the same pass the keyer goes idle rather than a few passes later
+    for (uint8_t i = 0; i < TRANSLATOR_MAX_STEPS && isSending && step(); i++)
     {
-        return;
     }
+}
 
+/// @brief advances the send state machine once, returns false while waiting on the keyer
+bool MorseCodeTranslator::step()
+{
     switch (currentState)
     {
     case TS_IDLE:
-        if (currentCharIndex < textToTranslate.length())
+        if (queueCount > 0)
         {
             currentState = TS_SENDING_CHARACTER;
+            return true;
         }
-        else
-        {
-            // complete
-            textToTranslate = "";
-            currentCharIndex = 0;
-            isSending = false;
+
+        // complete
+        isSending = false;
 
 #ifdef DEBUG_OUTPUT
-            Serial.println(F("Send complete."));
+        Serial.println(F("Send complete."));
 #endif
 
-        }
-        break;
+        return false;
+
     case TS_SENDING_CHARACTER:
-        if (textToTranslate[currentCharIndex] == ' ')
+    {
+        uint8_t token = tokenQueue[queueHead];
+        queueHead = (queueHead + 1) % TRANSLATOR_QUEUE_SIZE;
+        queueCount--;
+
+        if (token == MORSE_TOKEN_WORD_SPACE)
         {
             currentState = TS_END_OF_WORD;
         }
         else
         {
-            morse = getMorse(textToTranslate[currentCharIndex]);
+            morse = getMorseForToken(token);
             symbolIndex = 0; // Reset symbol index for new character
             currentState = TS_SENDING_SYMBOL;
         }
-        break;
+        return true;
+    }
     case TS_SENDING_SYMBOL:
         if (morse[symbolIndex] == '\0')
         {
             symbolIndex = 0;
             currentState = TS_END_OF_CHARACTER;
+            return true;
         }
-        else if (trySendSymbol(morse[symbolIndex]))
+        if (trySendSymbol(morse[symbolIndex]))
         {
             symbolIndex++;
+            return true;
         }
-        break;
+        return false;
 
     case TS_END_OF_CHARACTER:
         if (trySendCharacterSpace())
         {
             currentState = TS_SENDING_CHARACTER_SPACE;
+            return true;
         }
-        break;
+        return false;
 
     case TS_END_OF_WORD:
         if (trySendWordSpace())
         {
             currentState = TS_SENDING_WORD_SPACE;
+            return true;
         }
-        break;
+        return false;
 
     case TS_SENDING_WORD_SPACE:
     case TS_SENDING_CHARACTER_SPACE:
         if (keyer.isReadyForInput())
         {
-            currentCharIndex++;
             currentState = TS_IDLE;
+            return true;
         }
-        break;
+        return false;
 
     default:
-        break;
+        return false;
     }
 }
 
+/// @brief returns true when setText() will accept a new line
+bool MorseCodeTranslator::isReadyForText() const
+{
+    return !isSending;
+}
+
 bool MorseCodeTranslator::trySendSymbol(char symbol)
 {
     if (symbol == '.')
@@ -224,7 +313,7 @@ bool MorseCodeTranslator::trySendSymbol(char symbol)
     }
     else
     {
-        return false;
+        return true; // Skip anything else so a bad table entry cannot stall the queue
     }
 }
 
@@ -253,12 +342,23 @@ char MorseCodeTranslator::getChar(const String &morse)
 
 const char *MorseCodeTranslator::getMorse(char c)
 {
-    for (int i = 0; i < morseMapSize; i++)
+    uint8_t token;
+    if (MorseInputNormalizer::lookupCharacter(c, token))
     {
-        if (c == morseMap[i].character)
-        {
-            return morseMap[i].code;
-        }
+        return morseMap[token].code;
     }
     return ""; // Return empty string if character not found
 }
+
+const char *MorseCodeTranslator::getMorseForToken(uint8_t token)
+{
+    if (token < morseMapSize)
+    {
+        return morseMap[token].code;
+    }
+    if (token < morseMapSize + prosignMapSize)
+    {
+        return prosignMap[token - morseMapSize].code;
+    }
+    return "";
+}
@@ -7,7 +7,8 @@
  *     Defines the MorseCodeTranslator class that translates text into Morse code
  *     using a linked Keyer class to control signal output. It handles character
  *     and symbol translation, manages Morse code timing, and tracks translation
- *     state.
+ *     state. Input is normalized as it arrives (UTF-8, case, <prosigns>) into
+ *     a small queue of table indices.
  *
  * Usage:
  *     Include in projects that require text to Morse code conversion. The translator
@@ -30,6 +31,10 @@
 
 #include <Arduino.h>
 #include "Keyer.h"
+#include "MorseInputNormalizer.h"
+
+#define TRANSLATOR_MAX_STEPS 8   // state machine steps taken per update()
+#define TRANSLATOR_QUEUE_SIZE 64 // normalized symbols waiting to be sent, the most a line can run ahead of the keyer
 
 enum TranslatorState
 {
@@ -45,28 +50,43 @@ enum TranslatorState
 struct MorseCodeMapping
 {
     const char *code;
-    char character;
+    char character; // ASCII, or Latin-1 for extended characters
+};
+
+struct ProsignMapping
+{
+    const char *name; // sent as <name>, e.g. <AR>
+    const char *code;
 };
 
 class MorseCodeTranslator
 {
 public:
     MorseCodeTranslator(Keyer &keyer);
-    void setText(const String &text);
+    bool setText(const String &text);
+    size_t write(uint8_t byte);
+    int availableForWrite() const;
     void update();
+    bool isReadyForText() const;
+    static const char *getMorse(char c);
+    static char getChar(const String &morse);
     static const MorseCodeMapping morseMap[];
     static const int morseMapSize;
+    static const ProsignMapping prosignMap[];
+    static const int prosignMapSize;
 
 private:
     Keyer &keyer;
-    String textToTranslate;
+    MorseInputNormalizer normalizer;
+    uint8_t tokenQueue[TRANSLATOR_QUEUE_SIZE];
+    uint8_t queueHead = 0;
+    uint8_t queueCount = 0;
     bool isSending = false;
-    int currentCharIndex = 0;
     int symbolIndex = 0;
     const char *morse;
     TranslatorState currentState;
-    const char *getMorse(char c);
-    char getChar(const String &morse);
+    static const char *getMorseForToken(uint8_t token);
+    bool step();
     bool trySendSymbol(char symbol);
     bool trySendCharacterSpace();
     bool trySendWordSpace();
@@ -0,0 +1,197 @@
+/***********************************************************************
+ * File: MorseInputNormalizer.cpp
+ * Author: Dan Quigley, N7HQ
+ * Date: October 2026
+ *
+ * Description:
+ *     Implements the streaming UTF-8 / prosign normalizer used by
+ *     MorseCodeTranslator.
+ *
+ * Notes:
+ *     Extended characters are matched by their Latin-1 value, which is
+ *     how they are stored in morseMap. Code points above U+00FF have no
+ *     table entry and are dropped.
+ ***********************************************************************/
+
+#include "MorseInputNormalizer.h"
+#include "MorseCodeTranslator.h"
+
+MorseInputNormalizer::MorseInputNormalizer()
+{
+    reset();
+}
+
+void MorseInputNormalizer::reset()
+{
+    codePoint = 0;
+    minCodePoint = 0;
+    pendingBytes = 0;
+    afterWordSpace = true;
+    inProsign = false;
+    prosignLength = 0;
+}
+
+/// @brief feeds one input byte, returns how many tokens it completed (up to MORSE_MAX_TOKENS_PER_BYTE)
+uint8_t MorseInputNormalizer::push(uint8_t byte, uint8_t *tokens)
+{
+    if (pendingBytes > 0)
+    {
+        if ((byte & 0xC0) == 0x80)
+        {
+            codePoint = (codePoint << 6) | (byte & 0x3F);
+            if (--pendingBytes > 0)
+            {
+                return 0;
+            }
+            // Overlong forms, surrogates and values past U+10FFFF are malformed
+            if (codePoint < minCodePoint || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+            {
+                return 0;
+            }
+            return handleCodePoint(codePoint, tokens);
+        }
+        pendingBytes = 0; // Truncated sequence, drop it and treat byte as a new lead
+    }
+
+    if (byte < 0x80)
+    {
+        return handleCodePoint(byte, tokens);
+    }
+    else if (byte >= 0xC2 && byte <= 0xDF) // C0 and C1 could only start overlong forms
+    {
+        codePoint = byte & 0x1F;
+        minCodePoint = 0x80;
+        pendingBytes = 1;
+    }
+    else if ((byte & 0xF0) == 0xE0)
+    {
+        codePoint = byte & 0x0F;
+        minCodePoint = 0x800;
+        pendingBytes = 2;
+    }
+    else if (byte >= 0xF0 && byte <= 0xF4)
+    {
+        codePoint = byte & 0x07;
+        minCodePoint = 0x10000;
+        pendingBytes = 3;
+    }
+    return 0; // Stray continuation or invalid lead bytes are dropped
+}
+
+/// @brief letters held back waiting for a prosign's '>', each may still become a token
+uint8_t MorseInputNormalizer::getPendingTokens() const
+{
+    return inProsign ? prosignLength : 0;
+}
+
+uint8_t MorseInputNormalizer::handleCodePoint(uint32_t c, uint8_t *tokens)
+{
+    uint8_t count = 0;
+
+    // Upper-case ASCII and Latin-1 (U+00E0..U+00FE, except the division sign)
+    if ((c >= 'a' && c <= 'z') || (c >= 0xE0 && c <= 0xFE && c != 0xF7))
+    {
+        c -= 0x20;
+    }
+
+    if (inProsign)
+    {
+        if (c == '>')
+        {
+            inProsign = false;
+            if (!lookupProsign(tokens[0]))
+            {
+                return 0; // Unknown prosign
+            }
+            afterWordSpace = false;
+            return 1;
+        }
+        if (c >= 'A' && c <= 'Z' && prosignLength < MAX_PROSIGN_LENGTH)
+        {
+            prosign[prosignLength++] = (char)c;
+            return 0;
+        }
+        // Not a prosign after all: drop the '<', send the letters as text
+        // and handle this character normally
+        count = flushProsign(tokens);
+    }
+
+    if (c == '\r' || c == '\n')
+    {
+        // A line end separates words, but only once after a space or blank line
+        if (!afterWordSpace)
+        {
+            tokens[count++] = MORSE_TOKEN_WORD_SPACE;
+            afterWordSpace = true;
+        }
+        return count;
+    }
+
+    if (c == '<')
+    {
+        inProsign = true;
+        prosignLength = 0;
+        return count;
+    }
+
+    if (c == ' ')
+    {
+        tokens[count++] = MORSE_TOKEN_WORD_SPACE;
+        afterWordSpace = true;
+    }
+    else if (c <= 0xFF && lookupCharacter((char)c, tokens[count]))
+    {
+        count++;
+        afterWordSpace = false;
+    }
+    return count;
+}
+
+uint8_t MorseInputNormalizer::flushProsign(uint8_t *tokens)
+{
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < prosignLength; i++)
+    {
+        if (lookupCharacter(prosign[i], tokens[count]))
+        {
+            count++;
+            afterWordSpace = false;
+        }
+    }
+    inProsign = false;
+    prosignLength = 0;
+    return count;
+}
+
+bool MorseInputNormalizer::lookupProsign(uint8_t &token) const
+{
+    if (prosignLength == 0)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < MorseCodeTranslator::prosignMapSize; i++)
+    {
+        const char *name = MorseCodeTranslator::prosignMap[i].name;
+        if (strncmp(name, prosign, prosignLength) == 0 && name[prosignLength] == '\0')
+        {
+            token = MorseCodeTranslator::morseMapSize + i;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// @brief finds the morseMap index for an upper-case ASCII or Latin-1 character
+bool MorseInputNormalizer::lookupCharacter(char c, uint8_t &token)
+{
+    for (int i = 0; i < MorseCodeTranslator::morseMapSize; i++)
+    {
+        if (c == MorseCodeTranslator::morseMap[i].character)
+        {
+            token = i;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,61 @@
+/***********************************************************************
+ * File: MorseInputNormalizer.h
+ * Author: Dan Quigley, N7HQ
+ * Date: October 2026
+ *
+ * Description:
+ *     Single-pass streaming normalizer for translator input. Bytes are
+ *     pushed one at a time as they arrive; UTF-8 sequences are decoded,
+ *     letters are upper-cased (ASCII and Latin-1) and prosigns written
+ *     as <AR>, <SK>, ... are recognised, producing MorseCodeTranslator
+ *     table indices directly with no line buffer or string copy.
+ *
+ * Usage:
+ *     uint8_t tokens[MORSE_MAX_TOKENS_PER_BYTE];
+ *     uint8_t count = normalizer.push(byte, tokens); // queue count tokens
+ *
+ *     Tokens below morseMapSize index morseMap, tokens from
+ *     morseMapSize index prosignMap, and MORSE_TOKEN_WORD_SPACE marks a
+ *     space or line end (a line end right after a space adds nothing).
+ *     Characters with no Morse equivalent, malformed or overlong UTF-8
+ *     and unknown prosigns are dropped. A '<' not followed by letters
+ *     and '>' is dropped and the letters after it are sent as text, so
+ *     one byte can release the letters held back while waiting for '>'.
+ *
+ * Revisions:
+ *     1.0 - Initial release.
+ ***********************************************************************/
+
+#ifndef MORSE_INPUT_NORMALIZER_H
+#define MORSE_INPUT_NORMALIZER_H
+
+#include <Arduino.h>
+
+#define MORSE_TOKEN_WORD_SPACE 0xFF
+#define MAX_PROSIGN_LENGTH 3
+#define MORSE_MAX_TOKENS_PER_BYTE (MAX_PROSIGN_LENGTH + 1) // held letters plus the byte itself
+
+class MorseInputNormalizer
+{
+public:
+    MorseInputNormalizer();
+    uint8_t push(uint8_t byte, uint8_t *tokens);
+    uint8_t getPendingTokens() const;
+    void reset();
+    static bool lookupCharacter(char c, uint8_t &token);
+
+private:
+    uint32_t codePoint;       // UTF-8 sequence being decoded
+    uint32_t minCodePoint;    // smallest value its length may encode
+    uint8_t pendingBytes;     // continuation bytes still expected
+    bool afterWordSpace;      // last token was a word space, or none yet
+    bool inProsign;           // between '<' and '>'
+    uint8_t prosignLength;
+    char prosign[MAX_PROSIGN_LENGTH + 1];
+
+    uint8_t handleCodePoint(uint32_t c, uint8_t *tokens);
+    uint8_t flushProsign(uint8_t *tokens);
+    bool lookupProsign(uint8_t &token) const;
+};
+
+#endif // MORSE_INPUT_NORMALIZER_H
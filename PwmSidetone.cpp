@@ -0,0 +1,89 @@
+/***********************************************************************
+ * File: PwmSidetone.cpp
+ * Author: Dan Quigley, N7HQ
+ * Date: October 2026
+ *
+ * Description:
+ *     Timer setup and ISR for the built-in PWM sidetone. Compiled only
+ *     when PWM_SIDETONE is enabled in Keyer.h so the Timer1 vector is
+ *     not claimed on AD9833 builds.
+ *
+ * Revisions:
+ *     1.0 - Initial release.
+ ***********************************************************************/
+
+#include "Keyer.h" // for PWM_SIDETONE
+
+#if defined(PWM_SIDETONE)
+
+#ifndef __AVR__
+#error "PWM_SIDETONE requires an AVR board (Timer1/Timer2)"
+#endif
+
+static PwmSidetone *activeSidetone = nullptr;
+
+void PwmSidetone::begin(float frequency)
+{
+  dds.begin(SIDETONE_SAMPLE_RATE, frequency, SIDETONE_RISE_TIME_MS);
+  resetIsrStats();
+  activeSidetone = this;
+
+  pinMode(SIDETONE_PWM_PIN, OUTPUT);
+
+  noInterrupts();
+
+  // Timer2: fast PWM, non-inverting on OC2A, no prescaler -> 62.5 kHz carrier
+  TCCR2A = _BV(COM2A1) | _BV(WGM21) | _BV(WGM20);
+  TCCR2B = _BV(CS20);
+  OCR2A = SIDETONE_SILENCE;
+
+  // Timer1: CTC, no prescaler, one compare interrupt per sample
+  TCCR1A = 0;
+  TCCR1B = _BV(WGM12) | _BV(CS10);
+  OCR1A = F_CPU / SIDETONE_SAMPLE_RATE - 1;
+  TCNT1 = 0;
+  TIMSK1 = _BV(OCIE1A);
+
+  interrupts();
+}
+
+void PwmSidetone::setFrequency(float frequency)
+{
+  dds.setFrequency(frequency);
+}
+
+void PwmSidetone::key(bool state)
+{
+  dds.key(state);
+}
+
+uint16_t PwmSidetone::getMaxIsrCycles() const
+{
+  noInterrupts();
+  uint16_t cycles = maxIsrCycles;
+  interrupts();
+  return cycles;
+}
+
+unsigned long PwmSidetone::getIsrOverruns() const
+{
+  noInterrupts();
+  unsigned long overruns = isrOverruns;
+  interrupts();
+  return overruns;
+}
+
+void PwmSidetone::resetIsrStats()
+{
+  noInterrupts();
+  maxIsrCycles = 0;
+  isrOverruns = 0;
+  interrupts();
+}
+
+ISR(TIMER1_COMPA_vect)
+{
+  activeSidetone->serviceSample();
+}
+
+#endif
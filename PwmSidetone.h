@@ -0,0 +1,71 @@
+/***********************************************************************
+ * File: PwmSidetone.h
+ * Author: Dan Quigley, N7HQ
+ * Date: October 2026
+ *
+ * Description:
+ *     Built-in sidetone for boards without an AD9833. Timer2 runs an
+ *     8-bit fast PWM carrier at 62.5 kHz on OC2A (D11) and a Timer1
+ *     compare ISR feeds it one SidetoneDds sample per period. A simple
+ *     RC low-pass on D11 recovers the shaped sine wave.
+ *
+ * Usage:
+ *     Enable PWM_SIDETONE in Keyer.h. The Keyer then drives this class
+ *     in place of the AD9833 via begin() and key().
+ *
+ * Notes:
+ *     ATmega328P/168 (Uno, Nano) only: uses Timer1 and Timer2, so it
+ *     cannot be combined with Servo or tone(). The ISR measures its own
+ *     cost in CPU cycles against SIDETONE_ISR_BUDGET_CYCLES.
+ *
+ * Revisions:
+ *     1.0 - Initial release.
+ ***********************************************************************/
+
+#ifndef PwmSidetone_h
+#define PwmSidetone_h
+
+#include <Arduino.h>
+#include "SidetoneDds.h"
+
+#define SIDETONE_PWM_PIN 11            // OC2A
+#define SIDETONE_ISR_BUDGET_CYCLES 160 // ~16% of the 1024 cycles between samples
+
+class PwmSidetone
+{
+public:
+    void begin(float frequency);
+    void setFrequency(float frequency);
+    void key(bool state);
+    uint16_t getMaxIsrCycles() const;
+    unsigned long getIsrOverruns() const;
+    void resetIsrStats();
+    inline void serviceSample();
+
+private:
+    SidetoneDds dds;
+    volatile uint16_t maxIsrCycles;
+    volatile unsigned long isrOverruns;
+};
+
+// Called from the Timer1 compare ISR once per sample
+inline void PwmSidetone::serviceSample()
+{
+#ifdef __AVR__
+    OCR2A = dds.nextSample(); // Double buffered, takes effect at the next PWM period
+
+    // TCNT1 restarted at the compare match, so it holds cycles spent since
+    // the interrupt fired (latency + prologue + body, not the epilogue)
+    uint16_t cycles = TCNT1;
+    if (cycles > maxIsrCycles)
+    {
+        maxIsrCycles = cycles;
+    }
+    if (cycles > SIDETONE_ISR_BUDGET_CYCLES)
+    {
+        isrOverruns++;
+    }
+#endif
+}
+
+#endif
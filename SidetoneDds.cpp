@@ -0,0 +1,61 @@
+/***********************************************************************
+ * File: SidetoneDds.cpp
+ * Author: Dan Quigley, N7HQ
+ * Date: October 2026
+ *
+ * Description:
+ *     Wavetables and setup for the sidetone DDS core. nextSample() lives
+ *     in the header so it can be inlined into the timer ISR.
+ *
+ * Revisions:
+ *     1.0 - Initial release.
+ ***********************************************************************/
+
+#include "SidetoneDds.h"
+
+// round(127 * sin(2 * pi * i / 256))
+const int8_t SidetoneDds::sineTable[256] PROGMEM = {
+       0,    3,    6,    9,   12,   16,   19,   22,   25,   28,   31,   34,   37,   40,   43,   46,
+      49,   51,   54,   57,   60,   63,   65,   68,   71,   73,   76,   78,   81,   83,   85,   88,
+      90,   92,   94,   96,   98,  100,  102,  104,  106,  107,  109,  111,  112,  113,  115,  116,
+     117,  118,  120,  121,  122,  122,  123,  124,  125,  125,  126,  126,  126,  127,  127,  127,
+     127,  127,  127,  127,  126,  126,  126,  125,  125,  124,  123,  122,  122,  121,  120,  118,
+     117,  116,  115,  113,  112,  111,  109,  107,  106,  104,  102,  100,   98,   96,   94,   92,
+      90,   88,   85,   83,   81,   78,   76,   73,   71,   68,   65,   63,   60,   57,   54,   51,
+      49,   46,   43,   40,   37,   34,   31,   28,   25,   22,   19,   16,   12,    9,    6,    3,
+       0,   -3,   -6,   -9,  -12,  -16,  -19,  -22,  -25,  -28,  -31,  -34,  -37,  -40,  -43,  -46,
+     -49,  -51,  -54,  -57,  -60,  -63,  -65,  -68,  -71,  -73,  -76,  -78,  -81,  -83,  -85,  -88,
+     -90,  -92,  -94,  -96,  -98, -100, -102, -104, -106, -107, -109, -111, -112, -113, -115, -116,
+    -117, -118, -120, -121, -122, -122, -123, -124, -125, -125, -126, -126, -126, -127, -127, -127,
+    -127, -127, -127, -127, -126, -126, -126, -125, -125, -124, -123, -122, -122, -121, -120, -118,
+    -117, -116, -115, -113, -112, -111, -109, -107, -106, -104, -102, -100,  -98,  -96,  -94,  -92,
+     -90,  -88,  -85,  -83,  -81,  -78,  -76,  -73,  -71,  -68,  -65,  -63,  -60,  -57,  -54,  -51,
+     -49,  -46,  -43,  -40,  -37,  -34,  -31,  -28,  -25,  -22,  -19,  -16,  -12,   -9,   -6,   -3};
+
+// round(255 * (1 - cos(pi * i / 63)) / 2), one half period of a raised cosine
+const uint8_t SidetoneDds::envelopeTable[SIDETONE_ENVELOPE_STEPS] PROGMEM = {
+       0,    0,    1,    1,    3,    4,    6,    8,   10,   13,   16,   19,   22,   26,   30,   34,
+      38,   43,   48,   53,   58,   64,   69,   75,   81,   87,   93,   99,  105,  112,  118,  124,
+     131,  137,  143,  150,  156,  162,  168,  174,  180,  186,  191,  197,  202,  207,  212,  217,
+     221,  225,  229,  233,  236,  239,  242,  245,  247,  249,  251,  252,  254,  254,  255,  255};
+
+void SidetoneDds::begin(unsigned long rate, float frequency, float riseTimeMs)
+{
+    sampleRate = rate;
+    phase = 0;
+    envelope = 0;
+    keyed = false;
+
+    unsigned long riseSamples = max(1UL, (unsigned long)(riseTimeMs * sampleRate / 1000.0f));
+    envelopeStep = max(1UL, (unsigned long)SIDETONE_ENVELOPE_MAX / riseSamples);
+    setFrequency(frequency);
+}
+
+void SidetoneDds::setFrequency(float frequency)
+{
+    uint16_t step = (uint16_t)(frequency * 65536.0f / sampleRate + 0.5f);
+
+    noInterrupts(); // 16-bit store is not atomic on AVR
+    phaseStep = step;
+    interrupts();
+}
@@ -0,0 +1,81 @@
+/***********************************************************************
+ * File: SidetoneDds.h
+ * Author: Dan Quigley, N7HQ
+ * Date: October 2026
+ *
+ * Description:
+ *     Portable direct digital synthesis core for the built-in sidetone.
+ *     A 16-bit phase accumulator walks a 256-entry sine wavetable in
+ *     PROGMEM and each keyed element is shaped with a raised-cosine
+ *     rise and fall so the tone starts and stops without clicks.
+ *
+ * Usage:
+ *     Call begin() once, key() from the main loop, and nextSample() at
+ *     the sample rate (from the PwmSidetone timer ISR on AVR, or from
+ *     the Linux AudioSink when rendering to a file). Samples are 8-bit
+ *     unsigned PWM duty values centred on 128.
+ *
+ * Revisions:
+ *     1.0 - Initial release.
+ ***********************************************************************/
+
+#ifndef SidetoneDds_h
+#define SidetoneDds_h
+
+#include <Arduino.h>
+
+#define SIDETONE_SAMPLE_RATE 15625  // 16 MHz / 1024, well above twice the highest sidetone
+#define SIDETONE_RISE_TIME_MS 5.0f  // raised-cosine rise/fall per element
+#define SIDETONE_SILENCE 128        // PWM duty for zero output
+#define SIDETONE_ENVELOPE_STEPS 64  // entries in the envelope table
+#define SIDETONE_ENVELOPE_MAX ((SIDETONE_ENVELOPE_STEPS - 1) << 8)
+
+class SidetoneDds
+{
+public:
+    void begin(unsigned long sampleRate, float frequency, float riseTimeMs);
+    void setFrequency(float frequency);
+    void key(bool state) { keyed = state; }
+    bool isActive() const { return keyed || envelope != 0; }
+    inline uint8_t nextSample();
+
+private:
+    static const int8_t sineTable[256] PROGMEM;
+    static const uint8_t envelopeTable[SIDETONE_ENVELOPE_STEPS] PROGMEM;
+
+    unsigned long sampleRate;
+    uint16_t phaseStep;     // phase increment per sample (65536 = one cycle)
+    uint16_t phase;
+    uint16_t envelope;      // 8.8 fixed point index into envelopeTable
+    uint16_t envelopeStep;  // envelope increment per sample
+    volatile bool keyed;
+};
+
+// Inline so the ISR does not pay for a full call-clobbered register save
+inline uint8_t SidetoneDds::nextSample()
+{
+    if (keyed)
+    {
+        if (envelope < SIDETONE_ENVELOPE_MAX)
+        {
+            envelope = min((uint16_t)(envelope + envelopeStep), (uint16_t)SIDETONE_ENVELOPE_MAX);
+        }
+    }
+    else if (envelope > envelopeStep)
+    {
+        envelope -= envelopeStep;
+    }
+    else
+    {
+        envelope = 0;
+        phase = 0; // Start the next element on a zero crossing
+        return SIDETONE_SILENCE;
+    }
+
+    phase += phaseStep;
+    int8_t sample = (int8_t)pgm_read_byte(&sineTable[phase >> 8]);
+    uint8_t gain = pgm_read_byte(&envelopeTable[envelope >> 8]);
+    return SIDETONE_SILENCE + ((sample * gain) >> 8);
+}
+
+#endif
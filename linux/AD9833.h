@@ -0,0 +1,31 @@
+/***********************************************************************
+ * File: AD9833.h
+ * Author: Dan Quigley, N7HQ
+ * Date: October 2026
+ *
+ * Description:
+ *     Host stand-in for the AD9833 tone generator. The Linux build has
+ *     no SPI tone chip; sidetone is produced by the output sink from the
+ *     keyed output pin instead, so every call here is a no-op.
+ *
+ * Revisions:
+ *     1.0 - Initial release.
+ ***********************************************************************/
+
+#ifndef HOST_AD9833_H
+#define HOST_AD9833_H
+
+#define AD9833_OFF 0
+#define AD9833_SINE 1
+
+class AD9833
+{
+public:
+    AD9833(int fsyncPin, int clkPin, int dataPin) {}
+    void begin() {}
+    void setWave(int wave) {}
+    void setFrequency(float frequency, int channel) {}
+    void setFrequencyChannel(int channel) {}
+};
+
+#endif // HOST_AD9833_H
@@ -0,0 +1,107 @@
+/***********************************************************************
+ * File: Arduino.h
+ * Author: Dan Quigley, N7HQ
+ * Date: October 2026
+ *
+ * Description:
+ *     Host (Linux) stand-in for the subset of the Arduino core used by
+ *     Keyer and MorseCodeTranslator. Pins are kept in memory and every
+ *     digitalWrite() is forwarded to the active OutputSink so the same
+ *     keying engine can run unmodified on a Linux SBC.
+ *
+ * Usage:
+ *     Put this directory ahead of the Arduino core on the include path
+ *     (see linux/Makefile). Never included by the Arduino build.
+ *
+ * Revisions:
+ *     1.0 - Initial release.
+ ***********************************************************************/
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+
+using std::max;
+using std::min;
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define NUM_HOST_PINS 64
+#define LED_BUILTIN 13
+#define A0 14
+
+#define F(str) (str)
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+
+unsigned long micros();
+unsigned long millis();
+void delay(unsigned long ms);
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+
+class String
+{
+public:
+    String(const char *str = "") : value(str) {}
+    String(const std::string &str) : value(str) {}
+
+    unsigned int length() const { return value.size(); }
+    const char *c_str() const { return value.c_str(); }
+    char operator[](unsigned int index) const { return index < value.size() ? value[index] : '\0'; }
+    bool operator==(const char *str) const { return value == str; }
+    bool operator==(const String &str) const { return value == str.value; }
+    void toUpperCase()
+    {
+        for (char &c : value)
+        {
+            if (c >= 'a' && c <= 'z')
+            {
+                c -= 'a' - 'A';
+            }
+        }
+    }
+
+private:
+    std::string value;
+};
+
+class HardwareSerial
+{
+public:
+    void begin(unsigned long) {}
+    void print(const char *str) { fputs(str, stderr); }
+    void print(const String &str) { print(str.c_str()); }
+    void println(const char *str) { fprintf(stderr, "%s\n", str); }
+    void println(const String &str) { println(str.c_str()); }
+};
+
+extern HardwareSerial Serial;
+
+class SPIClass
+{
+public:
+    void begin() {}
+};
+
+extern SPIClass SPI;
+
+#endif // HOST_ARDUINO_H
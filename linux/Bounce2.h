@@ -0,0 +1,45 @@
+/***********************************************************************
+ * File: Bounce2.h
+ * Author: Dan Quigley, N7HQ
+ * Date: October 2026
+ *
+ * Description:
+ *     Host stand-in for Bounce2::Button. Host pins do not bounce, so
+ *     update() latches the pin state directly and interval() is ignored.
+ *
+ * Revisions:
+ *     1.0 - Initial release.
+ ***********************************************************************/
+
+#ifndef HOST_BOUNCE2_H
+#define HOST_BOUNCE2_H
+
+#include <Arduino.h>
+
+namespace Bounce2
+{
+    class Button
+    {
+    public:
+        void attach(int pin, int mode)
+        {
+            this->pin = pin;
+            pinMode(pin, mode);
+            state = digitalRead(pin);
+        }
+        void interval(uint16_t intervalMs) {}
+        bool update()
+        {
+            int previous = state;
+            state = digitalRead(pin);
+            return state != previous;
+        }
+        bool read() const { return state; }
+
+    private:
+        int pin = 0;
+        int state = HIGH;
+    };
+}
+
+#endif // HOST_BOUNCE2_H
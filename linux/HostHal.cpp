@@ -0,0 +1,143 @@
+/***********************************************************************
+ * File: HostHal.cpp
+ * Author: Dan Quigley, N7HQ
+ * Date: October 2026
+ *
+ * Description:
+ *     Implements the Arduino core subset declared in linux/Arduino.h on
+ *     top of CLOCK_MONOTONIC and an in-memory pin table.
+ *
+ * Revisions:
+ *     1.0 - Initial release.
+ ***********************************************************************/
+
+#include <time.h>
+#include "Keyer.h"
+#include "HostHal.h"
+#include "OutputSink.h"
+
+HardwareSerial Serial;
+SPIClass SPI;
+
+static int digitalPins[NUM_HOST_PINS];
+static int analogPins[NUM_HOST_PINS];
+static unsigned long pinChangeTimes[NUM_HOST_PINS];
+static OutputSink *outputSink = nullptr;
+static bool simulatedClock = false;
+static unsigned long simulatedTime = 0;
+
+unsigned long micros()
+{
+    if (simulatedClock)
+    {
+        return simulatedTime;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000UL + now.tv_nsec / 1000;
+}
+
+unsigned long millis()
+{
+    return micros() / 1000;
+}
+
+void delay(unsigned long ms)
+{
+    struct timespec duration = {(time_t)(ms / 1000), (long)(ms % 1000) * 1000000L};
+    clock_nanosleep(CLOCK_MONOTONIC, 0, &duration, nullptr);
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    if (pin < NUM_HOST_PINS && mode == INPUT_PULLUP)
+    {
+        digitalPins[pin] = HIGH; // Released paddles read HIGH
+    }
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+    if (pin >= NUM_HOST_PINS || digitalPins[pin] == value)
+    {
+        return;
+    }
+    digitalPins[pin] = value;
+    pinChangeTimes[pin] = micros();
+    if (outputSink)
+    {
+        outputSink->pinChanged(pin, value, pinChangeTimes[pin]);
+    }
+}
+
+int digitalRead(uint8_t pin)
+{
+    return pin < NUM_HOST_PINS ? digitalPins[pin] : LOW;
+}
+
+int analogRead(uint8_t pin)
+{
+    return pin < NUM_HOST_PINS ? analogPins[pin] : 0;
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax)
+{
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+void halSetOutputSink(OutputSink *sink)
+{
+    outputSink = sink;
+}
+
+void halSetInput(uint8_t pin, int value)
+{
+    if (pin < NUM_HOST_PINS)
+    {
+        digitalPins[pin] = value;
+    }
+}
+
+void halSetAnalog(uint8_t pin, int value)
+{
+    if (pin < NUM_HOST_PINS)
+    {
+        analogPins[pin] = value;
+    }
+}
+
+/// @brief micros() of the last digitalWrite() that changed the pin
+unsigned long halPinChangeTime(uint8_t pin)
+{
+    return pin < NUM_HOST_PINS ? pinChangeTimes[pin] : 0;
+}
+
+/// @brief finds the pot reading that Keyer::updateWPM() maps to the requested speed
+int halAnalogForWPM(int wpm)
+{
+    for (int value = 0; value <= 1023; value++)
+    {
+        if (map(value, 0, 1023, (INVERT_WPM ? 40 : 5), (INVERT_WPM ? 5 : 40)) == wpm)
+        {
+            return value;
+        }
+    }
+    return INVERT_WPM ? 0 : 1023; // Out of range, clamp to the fastest setting
+}
+
+void halUseSimulatedClock(unsigned long timeUs)
+{
+    simulatedClock = true;
+    simulatedTime = timeUs;
+}
+
+void halAdvanceClock(unsigned long us)
+{
+    simulatedTime += us;
+}
+
+void halUseRealClock()
+{
+    simulatedClock = false;
+}
@@ -0,0 +1,32 @@
+/***********************************************************************
+ * File: HostHal.h
+ * Author: Dan Quigley, N7HQ
+ * Date: October 2026
+ *
+ * Description:
+ *     Host-side controls for the Linux Arduino stand-in: routes pin
+ *     writes to an OutputSink and lets the daemon drive inputs (paddle
+ *     pins, the WPM "pot") that would be wired on real hardware. A
+ *     simulated clock lets benchmarks step micros() deterministically.
+ *
+ * Revisions:
+ *     1.0 - Initial release.
+ ***********************************************************************/
+
+#ifndef HOST_HAL_H
+#define HOST_HAL_H
+
+#include <Arduino.h>
+
+class OutputSink;
+
+void halSetOutputSink(OutputSink *sink);
+void halSetInput(uint8_t pin, int value);
+void halSetAnalog(uint8_t pin, int value);
+unsigned long halPinChangeTime(uint8_t pin);
+int halAnalogForWPM(int wpm);
+void halUseSimulatedClock(unsigned long timeUs);
+void halAdvanceClock(unsigned long us);
+void halUseRealClock();
+
+#endif // HOST_HAL_H
@@ -0,0 +1,164 @@
+/***********************************************************************
+ * File: HostTest.h
+ * Author: Dan Quigley, N7HQ
+ * Date: October 2026
+ *
+ * Description:
+ *     Minimal support for the host tests run by `make test`: a CHECK
+ *     macro that counts failures, an OutputSink that records every pin
+ *     edge, the PTT sequencing check over those edges, and a keyer wired
+ *     to the same pins as the sketch, running on the HAL's simulated
+ *     clock.
+ *
+ * Usage:
+ *     CHECK(cond, "format", ...);  // reports file:line and keeps going
+ *     return testResult("name");   // from main(), non-zero on failure
+ *
+ * Revisions:
+ *     1.0 - Initial release.
+ ***********************************************************************/
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <vector>
+
+#include "../Keyer.h"
+#include "../MorseCodeTranslator.h"
+#include "HostHal.h"
+#include "OutputSink.h"
+
+#define TEST_DIT_PIN 3
+#define TEST_DAH_PIN 2
+#define TEST_OUTPUT_PIN 4
+#define TEST_LED_PIN LED_BUILTIN
+#define TEST_PTT_PIN 5
+#define TEST_SPEED_PIN A0
+#define TEST_START_TIME 1000000UL
+
+static unsigned long testChecks = 0;
+static unsigned long testFailures = 0;
+
+#define CHECK(cond, ...)                                            \
+    do                                                              \
+    {                                                               \
+        testChecks++;                                               \
+        if (!(cond))                                                \
+        {                                                           \
+            if (testFailures++ < 20)                                \
+            {                                                       \
+                fprintf(stderr, "%s:%d: ", __FILE__, __LINE__);     \
+                fprintf(stderr, __VA_ARGS__);                       \
+                fprintf(stderr, "\n");                              \
+            }                                                       \
+        }                                                           \
+    } while (0)
+
+static int testResult(const char *name)
+{
+    fprintf(stderr, "%s: %lu checks, %lu failed\n", name, testChecks, testFailures);
+    return testFailures ? 1 : 0;
+}
+
+struct PinEdge
+{
+    uint8_t pin;
+    uint8_t value;
+    unsigned long time;
+};
+
+class EdgeRecorder : public OutputSink
+{
+public:
+    bool open() override { return true; }
+    void pinChanged(uint8_t pin, uint8_t value, unsigned long timeUs) override
+    {
+        edges.push_back({pin, value, timeUs});
+    }
+
+    std::vector<PinEdge> edges;
+};
+
+/// @brief checks the PTT sequencing invariant over recorded edges, returns the number of key downs
+static inline int checkPttEdges(const char *name, const std::vector<PinEdge> &edges, unsigned long leadUs)
+{
+    bool pttUp = false;
+    bool keyed = false;
+    unsigned long pttUpTime = 0;
+    int keyDowns = 0;
+
+    for (const PinEdge &edge : edges)
+    {
+        if (edge.pin == TEST_PTT_PIN)
+        {
+            CHECK(edge.value == HIGH || !keyed, "%s: PTT dropped while keyed at %lu", name, edge.time);
+            pttUp = edge.value == HIGH;
+            pttUpTime = edge.time;
+        }
+        else if (edge.pin == TEST_OUTPUT_PIN)
+        {
+            keyed = edge.value == HIGH;
+            if (!keyed)
+            {
+                continue;
+            }
+            keyDowns++;
+            CHECK(pttUp, "%s: keyed at %lu with PTT down", name, edge.time);
+            CHECK((long)(edge.time - pttUpTime) >= (long)leadUs,
+                  "%s: keyed %ld us after PTT, lead is %lu us", name, (long)(edge.time - pttUpTime), leadUs);
+        }
+    }
+    CHECK(!keyed && !pttUp, "%s: did not return to receive", name);
+    return keyDowns;
+}
+
+/// @brief a keyer and translator on the simulated clock, paddles released
+struct TestKeyer
+{
+    KeyerConfig config;
+    AD9833 toneGen;
+    Keyer keyer;
+    MorseCodeTranslator translator;
+    EdgeRecorder recorder;
+
+    TestKeyer(int wpm, int pttLeadMs, int pttHangMs, unsigned long startTime = TEST_START_TIME)
+        : config{TEST_DIT_PIN, TEST_DAH_PIN, TEST_OUTPUT_PIN, TEST_PTT_PIN,
+                 TEST_LED_PIN, pttHangMs, TEST_SPEED_PIN, pttLeadMs},
+          toneGen(0, 0, 0), keyer(config, toneGen), translator(keyer)
+    {
+        halUseSimulatedClock(startTime);
+        halSetOutputSink(nullptr);
+        setPaddles(false, false);
+        halSetInput(TEST_PTT_PIN, LOW);
+        halSetInput(TEST_OUTPUT_PIN, LOW);
+        keyer.setup();
+        keyer.setWPM(wpm);
+        halSetOutputSink(&recorder);
+    }
+
+    ~TestKeyer() { halSetOutputSink(nullptr); }
+
+    void setPaddles(bool dit, bool dah)
+    {
+        halSetInput(TEST_DIT_PIN, dit ? LOW : HIGH);
+        halSetInput(TEST_DAH_PIN, dah ? LOW : HIGH);
+    }
+
+    /// @brief one main loop pass, then the clock moves on
+    void step(unsigned long advanceUs)
+    {
+        keyer.update();
+        translator.update();
+        halAdvanceClock(advanceUs);
+    }
+
+    void run(unsigned long durationUs, unsigned long stepUs)
+    {
+        for (unsigned long elapsed = 0; elapsed < durationUs; elapsed += stepUs)
+        {
+            step(stepUs);
+        }
+    }
+};
+
+#endif // HOST_TEST_H
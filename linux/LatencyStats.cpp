@@ -0,0 +1,87 @@
+/***********************************************************************
+ * File: LatencyStats.cpp
+ * Author: Dan Quigley, N7HQ
+ * Date: October 2026
+ *
+ * Description:
+ *     Implements LatencyStats. record() is allocation free so it can be
+ *     called from the real-time keying thread.
+ ***********************************************************************/
+
+#include <math.h>
+#include <string.h>
+#include "LatencyStats.h"
+
+LatencyStats::LatencyStats()
+{
+    reset();
+}
+
+void LatencyStats::reset()
+{
+    count = 0;
+    minNs = INT64_MAX;
+    maxNs = INT64_MIN;
+    sumNs = 0;
+    sumSquaresNs = 0;
+    memset(histogram, 0, sizeof(histogram));
+}
+
+void LatencyStats::record(int64_t latencyNs)
+{
+    count++;
+    if (latencyNs < minNs)
+    {
+        minNs = latencyNs;
+    }
+    if (latencyNs > maxNs)
+    {
+        maxNs = latencyNs;
+    }
+    sumNs += latencyNs;
+    sumSquaresNs += (double)latencyNs * latencyNs;
+
+    int bucket = 0;
+    int64_t latencyUs = latencyNs / 1000;
+    while (bucket < LATENCY_BUCKETS - 1 && latencyUs >= (1LL << bucket))
+    {
+        bucket++;
+    }
+    histogram[bucket]++;
+}
+
+unsigned long long LatencyStats::getCount() const
+{
+    return count;
+}
+
+void LatencyStats::print(FILE *out, const char *label) const
+{
+    if (count == 0)
+    {
+        fprintf(out, "%s: no samples\n", label);
+        return;
+    }
+
+    double mean = sumNs / count;
+    double variance = sumSquaresNs / count - mean * mean;
+    fprintf(out, "%s: n=%llu min=%.1fus max=%.1fus mean=%.1fus stddev=%.1fus\n",
+            label, count, minNs / 1000.0, maxNs / 1000.0, mean / 1000.0,
+            sqrt(variance > 0 ? variance : 0) / 1000.0);
+
+    for (int i = 0; i < LATENCY_BUCKETS; i++)
+    {
+        if (histogram[i] == 0)
+        {
+            continue;
+        }
+        if (i == LATENCY_BUCKETS - 1)
+        {
+            fprintf(out, "  >=%7lldus %llu\n", 1LL << (i - 1), histogram[i]);
+        }
+        else
+        {
+            fprintf(out, "  < %7lldus %llu\n", 1LL << i, histogram[i]);
+        }
+    }
+}
@@ -0,0 +1,41 @@
+/***********************************************************************
+ * File: LatencyStats.h
+ * Author: Dan Quigley, N7HQ
+ * Date: October 2026
+ *
+ * Description:
+ *     Running latency statistics (min/max/mean/stddev and a log2
+ *     histogram) used by the Linux daemon to report how late each tick
+ *     and each keying edge lands relative to its scheduled deadline.
+ *
+ * Revisions:
+ *     1.0 - Initial release.
+ ***********************************************************************/
+
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define LATENCY_BUCKETS 20 // Bucket n counts samples below 2^n us, last bucket catches the rest
+
+class LatencyStats
+{
+public:
+    LatencyStats();
+    void reset();
+    void record(int64_t latencyNs);
+    void print(FILE *out, const char *label) const;
+    unsigned long long getCount() const;
+
+private:
+    unsigned long long count;
+    int64_t minNs;
+    int64_t maxNs;
+    double sumNs;
+    double sumSquaresNs;
+    unsigned long long histogram[LATENCY_BUCKETS];
+};
+
+#endif // LATENCY_STATS_H
@@ -0,0 +1,97 @@
+/***********************************************************************
+ * File: OutputSink.cpp
+ * Author: Dan Quigley, N7HQ
+ * Date: October 2026
+ *
+ * Description:
+ *     Implements the file/FIFO edge logger and the PCM sidetone sink.
+ *
+ * Notes:
+ *     Opening a FIFO blocks until a reader attaches, and a slow reader
+ *     will stall the keying thread. Both sinks are test stand-ins, not
+ *     real transmitter interfaces.
+ ***********************************************************************/
+
+#include "OutputSink.h"
+
+FileSink::FileSink(const char *path, uint8_t keyPin, uint8_t pttPin)
+    : path(path), keyPin(keyPin), pttPin(pttPin) {}
+
+FileSink::~FileSink()
+{
+    if (file && file != stdout)
+    {
+        fclose(file);
+    }
+}
+
+bool FileSink::open()
+{
+    file = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+    if (!file)
+    {
+        return false;
+    }
+    setvbuf(file, nullptr, _IOLBF, 0); // One edge per line, flushed as it happens
+    return true;
+}
+
+void FileSink::pinChanged(uint8_t pin, uint8_t value, unsigned long timeUs)
+{
+    const char *name = pin == keyPin ? "KEY" : (pin == pttPin ? "PTT" : nullptr);
+    if (!file || !name)
+    {
+        return;
+    }
+    fprintf(file, "%lu %s %d\n", timeUs, name, value);
+}
+
+AudioSink::AudioSink(const char *path, uint8_t keyPin, float frequency)
+    : path(path), keyPin(keyPin), frequency(frequency) {}
+
+AudioSink::~AudioSink()
+{
+    if (file && file != stdout)
+    {
+        fclose(file);
+    }
+}
+
+bool AudioSink::open()
+{
+    file = strcmp(path, "-") == 0 ? stdout : fopen(path, "wb");
+    dds.begin(SIDETONE_SAMPLE_RATE, frequency, SIDETONE_RISE_TIME_MS);
+    startTime = micros();
+    return file != nullptr;
+}
+
+void AudioSink::pinChanged(uint8_t pin, uint8_t value, unsigned long timeUs)
+{
+    if (pin != keyPin)
+    {
+        return;
+    }
+    render(timeUs); // Flush samples up to the edge before switching
+    dds.key(value == HIGH);
+}
+
+void AudioSink::render(unsigned long timeUs)
+{
+    if (!file)
+    {
+        return;
+    }
+
+    unsigned long long due = (unsigned long long)(timeUs - startTime) * SIDETONE_SAMPLE_RATE / 1000000ULL;
+    uint8_t buffer[256];
+    while (samplesWritten < due)
+    {
+        size_t count = min((unsigned long long)(sizeof(buffer) / sizeof(buffer[0])), due - samplesWritten);
+        for (size_t i = 0; i < count; i++)
+        {
+            buffer[i] = dds.nextSample(); // Same duty values the AVR ISR writes to OCR2A
+        }
+        fwrite(buffer, sizeof(buffer[0]), count, file);
+        samplesWritten += count;
+    }
+}
@@ -0,0 +1,70 @@
+/***********************************************************************
+ * File: OutputSink.h
+ * Author: Dan Quigley, N7HQ
+ * Date: October 2026
+ *
+ * Description:
+ *     Pluggable destinations for the keyer's output and PTT pins on the
+ *     Linux build. FileSink logs timestamped edges to a file or FIFO;
+ *     AudioSink renders the keyed sidetone through the same SidetoneDds
+ *     core as the AVR PWM sidetone, as raw unsigned 8-bit PCM that can
+ *     be piped into aplay or saved for spectral checks.
+ *
+ * Usage:
+ *     Create a sink with the keyer's pin numbers, call open(), then pass
+ *     it to halSetOutputSink(). The daemon calls render() once per tick.
+ *
+ * Revisions:
+ *     1.0 - Initial release.
+ ***********************************************************************/
+
+#ifndef OUTPUT_SINK_H
+#define OUTPUT_SINK_H
+
+#include <Arduino.h>
+#include "SidetoneDds.h"
+
+class OutputSink
+{
+public:
+    virtual ~OutputSink() {}
+    virtual bool open() = 0;
+    virtual void pinChanged(uint8_t pin, uint8_t value, unsigned long timeUs) = 0;
+    virtual void render(unsigned long timeUs) {}
+};
+
+class FileSink : public OutputSink
+{
+public:
+    FileSink(const char *path, uint8_t keyPin, uint8_t pttPin);
+    ~FileSink();
+    bool open() override;
+    void pinChanged(uint8_t pin, uint8_t value, unsigned long timeUs) override;
+
+private:
+    const char *path;
+    uint8_t keyPin;
+    uint8_t pttPin;
+    FILE *file = nullptr;
+};
+
+class AudioSink : public OutputSink
+{
+public:
+    AudioSink(const char *path, uint8_t keyPin, float frequency);
+    ~AudioSink();
+    bool open() override;
+    void pinChanged(uint8_t pin, uint8_t value, unsigned long timeUs) override;
+    void render(unsigned long timeUs) override;
+
+private:
+    const char *path;
+    uint8_t keyPin;
+    float frequency;
+    SidetoneDds dds;
+    unsigned long startTime = 0;
+    unsigned long long samplesWritten = 0;
+    FILE *file = nullptr;
+};
+
+#endif // OUTPUT_SINK_H
@@ -0,0 +1,631 @@
+/***********************************************************************
+ * File: keyerbench.cpp
+ * Author: Dan Quigley, N7HQ
+ * Date: October 2026
+ *
+ * Description:
+ *     Host benchmarks for the keyer and translator hot paths:
+ *         - Keyer::update() per call in each KeyerState: polling with the
+ *           clock frozen, and at each edge with the clock advanced to
+ *           getNextEventTime()
+ *         - the main loop (keyer and translator) per character sent
+ *         - getMorse()/getChar() lookup throughput
+ *         - Keyer::updateWPM() filter cost, steady and changing pot
+ *         - paddle pin to output edge through the main loop; the host
+ *           Bounce2 stub has no debounce, so the AVR's
+ *           DIGITAL_PIN_DEBOUNCE_INTERVAL comes on top of this
+ *         - keying edge lateness under background load, plain round
+ *           robin vs LoopScheduler
+ *
+ *     micros() runs on the HAL's simulated clock so every state can be
+ *     held still while it is measured; elapsed time is taken from
+ *     CLOCK_MONOTONIC directly. The scheduler benchmarks run on the real
+ *     clock with busy-wait tasks standing in for slow background work.
+ *
+ * Usage:
+ *     keyerbench [-o results.json] [-m min_time_ms] [-f filter] [-l label]
+ *
+ *     Results are written as JSON in the Google Benchmark layout, so
+ *     runs from two commits can be diffed with its compare.py tool.
+ *     A readable table is printed to stderr.
+ ***********************************************************************/
+
+#include <getopt.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../Keyer.h"
+#include "../MorseCodeTranslator.h"
+#include "../LoopScheduler.h"
+#include "HostHal.h"
+
+#define KEYER_DIT_PIN 3
+#define KEYER_DAH_PIN 2
+#define KEYER_OUTPUT_PIN 4
+#define KEYER_LED_PIN LED_BUILTIN
+#define KEYER_PTT_PIN 5
+#define KEYER_SPEED_PIN A0
+
+#define BENCH_WPM 20
+#define BENCH_PTT_HANG_TIME 250 // in ms
+#define BENCH_START_TIME 1000000UL
+#define DEFAULT_MIN_TIME_MS 200
+#define LATENCY_SAMPLES 20000
+#define TRANSLATOR_TEXT "PARIS PARIS PARIS PARIS PARIS"
+#define TRANSLATOR_STEP_US 50
+#define LOAD_WPM 60 // above the pot range, set directly for more edges per run
+#define LOAD_RUN_TIME_MS 4000
+#define LOAD_PARSE_PERIOD 3000 // us, a slow serial parse
+#define LOAD_PARSE_COST 800
+#define LOAD_ADC_PERIOD 1000   // us, an ADC read
+#define LOAD_ADC_COST 120
+
+struct BenchResult
+{
+    std::string name;
+    unsigned long long iterations;
+    double nsPerOp;
+    std::vector<std::pair<std::string, double>> counters;
+};
+
+static std::vector<BenchResult> results;
+static double minTimeNs = DEFAULT_MIN_TIME_MS * 1e6;
+static const char *filter = nullptr;
+static AD9833 toneGen(0, 0, 0);
+
+static inline double nowNs()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+static bool selected(const std::string &name)
+{
+    return !filter || name.find(filter) != std::string::npos;
+}
+
+static void report(const BenchResult &result)
+{
+    fprintf(stderr, "%-44s %12.1f ns %12llu", result.name.c_str(), result.nsPerOp, result.iterations);
+    for (const auto &counter : result.counters)
+    {
+        fprintf(stderr, "  %s=%.1f", counter.first.c_str(), counter.second);
+    }
+    fprintf(stderr, "\n");
+    results.push_back(result);
+}
+
+/// @brief runs setup() then body() in growing batches until the batch takes minTimeNs
+template <typename Setup, typename Body>
+static void runBenchmark(const std::string &name, Setup setup, Body body)
+{
+    if (!selected(name))
+    {
+        return;
+    }
+
+    unsigned long long iterations = 1;
+    double elapsed = 0;
+    for (;;)
+    {
+        setup();
+        double start = nowNs();
+        for (unsigned long long i = 0; i < iterations; i++)
+        {
+            body();
+        }
+        elapsed = nowNs() - start;
+        if (elapsed >= minTimeNs || iterations >= 1000000000ULL)
+        {
+            break;
+        }
+        // Aim past the target in one step, like Google Benchmark does
+        double scale = elapsed > 0 ? 1.4 * minTimeNs / elapsed : 10.0;
+        iterations = (unsigned long long)(iterations * std::min(std::max(scale, 2.0), 10.0));
+    }
+    report({name, iterations, elapsed / iterations, {}});
+}
+
+/// @brief a keyer with fresh config, settled at BENCH_WPM with paddles released
+struct BenchKeyer
+{
+    KeyerConfig config;
+    Keyer keyer;
+    MorseCodeTranslator translator;
+
+    BenchKeyer()
+        : config{KEYER_DIT_PIN, KEYER_DAH_PIN, KEYER_OUTPUT_PIN, KEYER_PTT_PIN,
+                 KEYER_LED_PIN, BENCH_PTT_HANG_TIME, KEYER_SPEED_PIN, 0},
+          keyer(config, toneGen), translator(keyer)
+    {
+        halUseSimulatedClock(BENCH_START_TIME);
+        halSetInput(KEYER_DIT_PIN, HIGH);
+        halSetInput(KEYER_DAH_PIN, HIGH);
+        halSetAnalog(KEYER_SPEED_PIN, halAnalogForWPM(BENCH_WPM));
+        keyer.setup();
+        for (int i = 0; i < NUM_READINGS * 2; i++)
+        {
+            keyer.updateWPM(); // Fill the WPM filter
+        }
+    }
+
+    void step(unsigned long advanceUs)
+    {
+        halAdvanceClock(advanceUs);
+        keyer.update();
+    }
+
+    void setPaddles(bool dit, bool dah)
+    {
+        halSetInput(KEYER_DIT_PIN, dit ? LOW : HIGH);
+        halSetInput(KEYER_DAH_PIN, dah ? LOW : HIGH);
+    }
+
+    /// @brief drives the state machine into the given state with the clock frozen there
+    bool enterState(KeyerState state)
+    {
+        unsigned long element = 1200000UL / BENCH_WPM + 1; // Just past one dit
+
+        switch (state)
+        {
+        case IDLE:
+            break;
+        case TRANSMITTING_DIT:
+            setPaddles(true, false);
+            step(0);
+            step(0); // First update raises PTT, second keys
+            break;
+        case TRANSMITTING_DAH:
+            setPaddles(false, true);
+            step(0);
+            step(0);
+            break;
+        case IAMBIC_DIT:
+            setPaddles(true, true);
+            step(0);
+            step(0);
+            break;
+        case IAMBIC_DAH:
+            setPaddles(true, true);
+            step(0);
+            step(0);
+            step(element);
+            step(element);
+            break;
+        case WAITING_ELEMENT_SPACE:
+            setPaddles(true, false);
+            step(0);
+            step(0);
+            setPaddles(false, false);
+            step(element);
+            break;
+        case WAITING_CHARACTER_SPACE:
+            keyer.sendCharacterSpace();
+            break;
+        case WAITING_WORD_SPACE:
+            keyer.sendWordSpace();
+            break;
+        }
+        return keyer.getState() == state;
+    }
+};
+
+static const char *stateName(KeyerState state)
+{
+    switch (state)
+    {
+    case IDLE: return "IDLE";
+    case TRANSMITTING_DIT: return "TRANSMITTING_DIT";
+    case TRANSMITTING_DAH: return "TRANSMITTING_DAH";
+    case WAITING_ELEMENT_SPACE: return "WAITING_ELEMENT_SPACE";
+    case IAMBIC_DIT: return "IAMBIC_DIT";
+    case IAMBIC_DAH: return "IAMBIC_DAH";
+    case WAITING_CHARACTER_SPACE: return "WAITING_CHARACTER_SPACE";
+    case WAITING_WORD_SPACE: return "WAITING_WORD_SPACE";
+    }
+    return "UNKNOWN";
+}
+
+/// @brief time of one update() with the clock frozen, the poll that finds no edge
+static void benchKeyerPoll(KeyerState state)
+{
+    std::string name = std::string("BM_KeyerUpdate/poll/") + stateName(state);
+    BenchKeyer *bench = nullptr;
+    runBenchmark(
+        name,
+        [&]()
+        {
+            delete bench;
+            bench = new BenchKeyer();
+            if (!bench->enterState(state))
+            {
+                fprintf(stderr, "%s: could not reach state\n", name.c_str());
+            }
+        },
+        [&]() { bench->keyer.update(); });
+    delete bench;
+}
+
+/// @brief time of one update() at the keyer's next edge, so the table lookup and the
+/// output path run every call. The paddles stay held, or the space is requested again
+/// from idle, so the state comes round again: each op is one edge of that cycle.
+static void benchKeyerEdge(KeyerState state)
+{
+    std::string name = std::string("BM_KeyerUpdate/edge/") + stateName(state);
+    BenchKeyer *bench = nullptr;
+    runBenchmark(
+        name,
+        [&]()
+        {
+            delete bench;
+            bench = new BenchKeyer();
+            if (!bench->enterState(state))
+            {
+                fprintf(stderr, "%s: could not reach state\n", name.c_str());
+            }
+            if (state == WAITING_ELEMENT_SPACE)
+            {
+                bench->setPaddles(true, false); // Repeat dits rather than ending in IDLE
+            }
+        },
+        [&]()
+        {
+            if (bench->keyer.isReadyForInput())
+            {
+                state == WAITING_CHARACTER_SPACE ? bench->keyer.sendCharacterSpace() : bench->keyer.sendWordSpace();
+                return;
+            }
+            unsigned long edge;
+            if (bench->keyer.getNextEventTime(edge) && (long)(edge - micros()) > 0)
+            {
+                halAdvanceClock(edge - micros());
+            }
+            bench->keyer.update();
+        });
+    delete bench;
+}
+
+static void benchKeyerUpdate()
+{
+    const KeyerState states[] = {IDLE, TRANSMITTING_DIT, TRANSMITTING_DAH, WAITING_ELEMENT_SPACE,
+                                 IAMBIC_DIT, IAMBIC_DAH, WAITING_CHARACTER_SPACE, WAITING_WORD_SPACE};
+    for (KeyerState state : states)
+    {
+        benchKeyerPoll(state);
+    }
+    // IDLE has no timed edge of its own, leaving it is BM_PaddleToOutput
+    for (KeyerState state : states)
+    {
+        if (state != IDLE)
+        {
+            benchKeyerEdge(state);
+        }
+    }
+}
+
+static void benchUpdateWPM()
+{
+    BenchKeyer *bench = nullptr;
+    auto setup = [&]()
+    {
+        delete bench;
+        bench = new BenchKeyer();
+    };
+
+    runBenchmark("BM_UpdateWPM/steady", setup, [&]() { bench->keyer.updateWPM(); });
+
+    // Swing the pot every call so each filter window lands on a new speed
+    int readings[2] = {halAnalogForWPM(15), halAnalogForWPM(25)};
+    int next = 0;
+    runBenchmark("BM_UpdateWPM/changing", setup,
+                 [&]()
+                 {
+                     halSetAnalog(KEYER_SPEED_PIN, readings[next ^= 1]);
+                     bench->keyer.updateWPM();
+                 });
+    delete bench;
+}
+
+static void benchLookups()
+{
+    const int size = MorseCodeTranslator::morseMapSize;
+    std::vector<String> codes;
+    for (int i = 0; i < size; i++)
+    {
+        codes.push_back(String(MorseCodeTranslator::morseMap[i].code));
+    }
+
+    int index = 0;
+    volatile uintptr_t sink = 0;
+    auto reset = [&]() { index = 0; };
+
+    runBenchmark("BM_GetMorse", reset,
+                 [&]()
+                 {
+                     sink = sink + (uintptr_t)MorseCodeTranslator::getMorse(MorseCodeTranslator::morseMap[index].character);
+                     index = index + 1 == size ? 0 : index + 1;
+                 });
+
+    runBenchmark("BM_GetChar", reset,
+                 [&]()
+                 {
+                     sink = sink + MorseCodeTranslator::getChar(codes[index]);
+                     index = index + 1 == size ? 0 : index + 1;
+                 });
+}
+
+/// @brief main loop cost of sending text, keyer included, timed over whole messages
+static void benchTranslator()
+{
+    const char *name = "BM_TranslatorSend/per_char";
+    if (!selected(name))
+    {
+        return;
+    }
+
+    // Timestamps around single update() calls cost as much as the call itself,
+    // so whole messages are timed and divided out like runBenchmark() does
+    unsigned long long passes = 0;
+    unsigned long long characters = 0;
+    double total = 0;
+    while (total < minTimeNs)
+    {
+        BenchKeyer bench;
+        bench.translator.setText(String(TRANSLATOR_TEXT));
+        double start = nowNs();
+        do
+        {
+            bench.step(TRANSLATOR_STEP_US);
+            bench.translator.update();
+            passes++;
+        } while (!bench.translator.isReadyForText());
+        total += nowNs() - start;
+        characters += strlen(TRANSLATOR_TEXT);
+    }
+
+    report({name, characters, total / characters, {{"ns_per_pass", total / passes}, {"passes", (double)passes}}});
+}
+
+static void benchPaddleToOutput()
+{
+    const char *name = "BM_PaddleToOutput/no_debounce";
+    if (!selected(name))
+    {
+        return;
+    }
+
+    BenchKeyer bench;
+    std::vector<double> latencies;
+    latencies.reserve(LATENCY_SAMPLES);
+    unsigned long long passes = 0;
+
+    for (int i = 0; i < LATENCY_SAMPLES; i++)
+    {
+        // One main loop pass at a time until the output goes high
+        bench.setPaddles(true, false);
+        double start = nowNs();
+        while (digitalRead(KEYER_OUTPUT_PIN) == LOW)
+        {
+            bench.keyer.update();
+            bench.translator.update();
+            passes++;
+        }
+        latencies.push_back(nowNs() - start);
+
+        bench.setPaddles(false, false);
+        while (bench.keyer.getState() != IDLE)
+        {
+            bench.step(1000);
+        }
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    double sum = 0;
+    for (double latency : latencies)
+    {
+        sum += latency;
+    }
+    report({name, (unsigned long long)latencies.size(), sum / latencies.size(),
+            {{"p50_ns", latencies[latencies.size() / 2]},
+             {"p99_ns", latencies[latencies.size() * 99 / 100]},
+             {"max_ns", latencies.back()},
+             {"loop_passes", (double)passes / latencies.size()}}});
+}
+
+static BenchKeyer *loadBench = nullptr;
+static std::vector<double> edgeLateness;
+
+static void busyWait(unsigned long us)
+{
+    double end = nowNs() + us * 1000.0;
+    while (nowNs() < end)
+    {
+    }
+}
+
+// Lateness is the output pin change minus the keyer deadline that led to it. That
+// covers edges the translator starts once a space ends, not only the keyer's own.
+// The deadline is read once before the pass and an edge counts only if it came
+// at or after it, as keyerd does: a deadline that passes between that read and
+// update() moves the core on, and must not be charged to a later edge.
+static void loadKeyingTask()
+{
+    unsigned long edgeTime;
+    bool edgePending = loadBench->keyer.getNextEventTime(edgeTime);
+    int keyBefore = digitalRead(KEYER_OUTPUT_PIN);
+    loadBench->keyer.update();
+    loadBench->translator.update();
+    if (edgePending && digitalRead(KEYER_OUTPUT_PIN) != keyBefore)
+    {
+        long lateness = (long)(halPinChangeTime(KEYER_OUTPUT_PIN) - edgeTime);
+        if (lateness >= 0)
+        {
+            edgeLateness.push_back(lateness * 1000.0);
+        }
+    }
+    if (loadBench->translator.isReadyForText())
+    {
+        loadBench->translator.setText(String(TRANSLATOR_TEXT));
+    }
+}
+
+static void loadParseTask()
+{
+    busyWait(LOAD_PARSE_COST);
+}
+
+static void loadAdcTask()
+{
+    busyWait(LOAD_ADC_COST);
+}
+
+static void reportLateness(const char *name)
+{
+    std::sort(edgeLateness.begin(), edgeLateness.end());
+    double sum = 0;
+    for (double late : edgeLateness)
+    {
+        sum += late;
+    }
+    size_t n = std::max((size_t)1, edgeLateness.size());
+    report({name, (unsigned long long)edgeLateness.size(), sum / n,
+            {{"p90_ns", edgeLateness.empty() ? 0 : edgeLateness[edgeLateness.size() * 90 / 100]},
+             {"p99_ns", edgeLateness.empty() ? 0 : edgeLateness[edgeLateness.size() * 99 / 100]},
+             {"max_ns", edgeLateness.empty() ? 0 : edgeLateness.back()}}});
+}
+
+/// @brief sends text at LOAD_WPM on the real clock while busy tasks compete for the loop
+static void benchEdgeLateness(const char *name, bool scheduled)
+{
+    if (!selected(name))
+    {
+        return;
+    }
+
+    BenchKeyer bench;
+    bench.keyer.setWPM(LOAD_WPM);
+    halUseRealClock();
+    loadBench = &bench;
+    edgeLateness.clear();
+
+    LoopScheduler scheduler(bench.keyer);
+    scheduler.setKeyingTask(loadKeyingTask, 50);
+    scheduler.addTask("parse", loadParseTask, LOAD_PARSE_PERIOD, LOAD_PARSE_COST);
+    scheduler.addTask("adc", loadAdcTask, LOAD_ADC_PERIOD, LOAD_ADC_COST);
+
+    unsigned long nextParse = micros();
+    unsigned long nextAdc = micros();
+    double end = nowNs() + LOAD_RUN_TIME_MS * 1e6;
+    while (nowNs() < end)
+    {
+        if (scheduled)
+        {
+            scheduler.run();
+            continue;
+        }
+
+        // The old fixed round robin: every task whenever it is due
+        loadKeyingTask();
+        if ((long)(micros() - nextParse) >= 0)
+        {
+            nextParse += LOAD_PARSE_PERIOD;
+            loadParseTask();
+        }
+        if ((long)(micros() - nextAdc) >= 0)
+        {
+            nextAdc += LOAD_ADC_PERIOD;
+            loadAdcTask();
+        }
+    }
+
+    reportLateness(name);
+    loadBench = nullptr;
+}
+
+static void writeJson(FILE *out, const char *label)
+{
+    char host[256] = "";
+    gethostname(host, sizeof(host) - 1);
+    char date[64];
+    time_t now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", localtime(&now));
+
+    fprintf(out, "{\n  \"context\": {\n");
+    fprintf(out, "    \"date\": \"%s\",\n", date);
+    fprintf(out, "    \"host_name\": \"%s\",\n", host);
+    fprintf(out, "    \"executable\": \"keyerbench\",\n");
+    fprintf(out, "    \"num_cpus\": %ld,\n", sysconf(_SC_NPROCESSORS_ONLN));
+    fprintf(out, "    \"label\": \"%s\",\n", label);
+    fprintf(out, "    \"library_build_type\": \"release\"\n");
+    fprintf(out, "  },\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchResult &result = results[i];
+        fprintf(out, "    {\n");
+        fprintf(out, "      \"name\": \"%s\",\n", result.name.c_str());
+        fprintf(out, "      \"run_name\": \"%s\",\n", result.name.c_str());
+        fprintf(out, "      \"run_type\": \"iteration\",\n");
+        fprintf(out, "      \"iterations\": %llu,\n", result.iterations);
+        fprintf(out, "      \"real_time\": %.3f,\n", result.nsPerOp);
+        fprintf(out, "      \"cpu_time\": %.3f,\n", result.nsPerOp);
+        for (const auto &counter : result.counters)
+        {
+            fprintf(out, "      \"%s\": %.3f,\n", counter.first.c_str(), counter.second);
+        }
+        fprintf(out, "      \"time_unit\": \"ns\"\n");
+        fprintf(out, "    }%s\n", i + 1 < results.size() ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+static void usage()
+{
+    fprintf(stderr, "usage: keyerbench [-o results.json] [-m min_time_ms] [-f filter] [-l label]\n");
+}
+
+int main(int argc, char **argv)
+{
+    const char *outPath = nullptr;
+    const char *label = "";
+    int opt;
+    while ((opt = getopt(argc, argv, "o:m:f:l:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 'o': outPath = optarg; break;
+        case 'm': minTimeNs = atof(optarg) * 1e6; break;
+        case 'f': filter = optarg; break;
+        case 'l': label = optarg; break;
+        default:
+            usage();
+            return 1;
+        }
+    }
+
+    fprintf(stderr, "%-44s %15s %12s\n", "Benchmark", "Time", "Iterations");
+    benchKeyerUpdate();
+    benchUpdateWPM();
+    benchLookups();
+    benchTranslator();
+    benchPaddleToOutput();
+    benchEdgeLateness("BM_EdgeLateness/round_robin", false);
+    benchEdgeLateness("BM_EdgeLateness/scheduled", true);
+
+    FILE *out = outPath ? fopen(outPath, "w") : stdout;
+    if (!out)
+    {
+        fprintf(stderr, "keyerbench: cannot write %s\n", outPath);
+        return 1;
+    }
+    writeJson(out, label);
+    if (out != stdout)
+    {
+        fclose(out);
+    }
+    return 0;
+}
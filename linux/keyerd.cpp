@@ -0,0 +1,488 @@
+/***********************************************************************
+ * File: keyerd.cpp
+ * Author: Dan Quigley, N7HQ
+ * Date: October 2026
+ *
+ * Description:
+ *     Linux keyer daemon. Hosts the same Keyer and MorseCodeTranslator
+ *     used on the AVR build on a SCHED_FIFO thread that sleeps to
+ *     absolute clock_nanosleep() deadlines instead of busy-polling
+ *     micros(): the keyer's next edge when one is pending, otherwise
+ *     the next periodic tick. Text arrives line by line over a Unix
+ *     socket; keyed output and PTT go to a pluggable OutputSink.
+ *
+ * Usage:
+ *     keyerd [-s socket] [-o file:PATH|audio:PATH] [-t tick_us] [-w wpm]
+ *            [-r rt_priority] [-l ptt_lead_ms] [-g ptt_hang_ms]
+ *
+ *     Each line written to the socket is queued for sending. Lines
+ *     starting with '/' are commands:
+ *         /wpm N   set the speed
+ *         /stats   report tick and edge latency
+ *         /reset   clear latency statistics
+ *
+ *     Example: echo "CQ CQ DE N7HQ" | socat - UNIX-CONNECT:/tmp/keyerd.sock
+ *
+ * Notes:
+ *     SCHED_FIFO and mlockall() need CAP_SYS_NICE / CAP_IPC_LOCK (or
+ *     root); without them the daemon warns and runs at normal priority.
+ ***********************************************************************/
+
+#include <errno.h>
+#include <getopt.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+
+#include "../Keyer.h"
+#include "../MorseCodeTranslator.h"
+#include "HostHal.h"
+#include "LatencyStats.h"
+#include "OutputSink.h"
+
+// Same pin numbers as simple_keyer.ino, they only name entries in the host pin table
+#define KEYER_DIT_PIN 3
+#define KEYER_DAH_PIN 2
+#define KEYER_OUTPUT_PIN 4
+#define KEYER_LED_PIN LED_BUILTIN
+#define KEYER_PTT_PIN 5
+#define KEYER_SPEED_PIN A0
+
+#define DEFAULT_SOCKET_PATH "/tmp/keyerd.sock"
+#define DEFAULT_TICK_US 250
+#define DEFAULT_WPM 20
+#define DEFAULT_RT_PRIORITY 80
+#define DEFAULT_PTT_LEAD_TIME 15 // in ms
+#define DEFAULT_PTT_HANG_TIME 250 // in ms
+#define NSEC_PER_SEC 1000000000L
+
+static std::atomic<bool> running(true);
+static std::atomic<int> requestedWPM(DEFAULT_WPM);
+
+static std::mutex textMutex;
+static std::deque<std::string> textQueue;
+
+static std::mutex statsMutex;
+static LatencyStats tickStats;   // wake-up lateness of every wake-up
+static LatencyStats edgeStats;   // keyer deadline to the output pin change
+static std::atomic<unsigned long long> missedTicks(0);
+
+struct DaemonOptions
+{
+    const char *socketPath = DEFAULT_SOCKET_PATH;
+    const char *sink = "file:-";
+    long tickUs = DEFAULT_TICK_US;
+    int wpm = DEFAULT_WPM;
+    int rtPriority = DEFAULT_RT_PRIORITY;
+    int pttLeadTime = DEFAULT_PTT_LEAD_TIME;
+    int pttHangTime = DEFAULT_PTT_HANG_TIME;
+};
+
+struct KeyingContext
+{
+    Keyer *keyer;
+    MorseCodeTranslator *translator;
+    OutputSink *sink;
+    long tickNs;
+};
+
+static void onSignal(int)
+{
+    running = false;
+}
+
+static void timespecAddNs(struct timespec &t, long ns)
+{
+    t.tv_nsec += ns;
+    while (t.tv_nsec >= NSEC_PER_SEC)
+    {
+        t.tv_nsec -= NSEC_PER_SEC;
+        t.tv_sec++;
+    }
+}
+
+static struct timespec timespecFromMicros(unsigned long us)
+{
+    struct timespec t;
+    t.tv_sec = us / 1000000UL;
+    t.tv_nsec = (us % 1000000UL) * 1000L;
+    return t;
+}
+
+static int64_t timespecDiffNs(const struct timespec &a, const struct timespec &b)
+{
+    return (int64_t)(a.tv_sec - b.tv_sec) * NSEC_PER_SEC + (a.tv_nsec - b.tv_nsec);
+}
+
+static void *keyingThread(void *arg)
+{
+    KeyingContext *ctx = static_cast<KeyingContext *>(arg);
+    int currentWPM = -1;
+    std::string line;       // line being streamed into the translator
+    size_t lineOffset = 0;
+
+    // micros() is CLOCK_MONOTONIC on the host, so keyer times map straight onto deadlines
+    struct timespec tick;
+    clock_gettime(CLOCK_MONOTONIC, &tick);
+    timespecAddNs(tick, ctx->tickNs);
+
+    while (running)
+    {
+        // Sleep to the keyer's next edge when it comes before the next tick
+        struct timespec deadline = tick;
+        unsigned long edgeTime;
+        bool edgePending = ctx->keyer->getNextEventTime(edgeTime);
+        if (edgePending)
+        {
+            struct timespec edge = timespecFromMicros(edgeTime);
+            if (timespecDiffNs(edge, tick) < 0)
+            {
+                deadline = edge;
+            }
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr);
+
+        struct timespec woke;
+        clock_gettime(CLOCK_MONOTONIC, &woke);
+
+        if (requestedWPM != currentWPM)
+        {
+            currentWPM = requestedWPM;
+            halSetAnalog(KEYER_SPEED_PIN, halAnalogForWPM(currentWPM));
+        }
+
+        int keyBefore = digitalRead(KEYER_OUTPUT_PIN);
+        ctx->keyer->updateWPM();
+        ctx->keyer->update();
+
+        // Never block the keying thread on the socket thread, a busy queue just waits a tick
+        if (lineOffset == line.size() && textMutex.try_lock())
+        {
+            if (!textQueue.empty())
+            {
+                line.swap(textQueue.front());
+                line.push_back('\n');
+                lineOffset = 0;
+                textQueue.pop_front();
+            }
+            textMutex.unlock();
+        }
+        while (lineOffset < line.size() && ctx->translator->availableForWrite() > 0)
+        {
+            ctx->translator->write(line[lineOffset++]);
+        }
+
+        ctx->translator->update();
+        ctx->sink->render(micros());
+
+        // An output edge in a pass where the keyer's deadline was due was meant for
+        // that deadline, edges from a new paddle press or new text had none
+        bool edge = digitalRead(KEYER_OUTPUT_PIN) != keyBefore;
+        bool edgeDue = edgePending && (long)(halPinChangeTime(KEYER_OUTPUT_PIN) - edgeTime) >= 0;
+        int64_t lateNs = timespecDiffNs(woke, deadline);
+        if (statsMutex.try_lock())
+        {
+            tickStats.record(lateNs);
+            if (edge && edgeDue)
+            {
+                edgeStats.record((int64_t)(long)(halPinChangeTime(KEYER_OUTPUT_PIN) - edgeTime) * 1000);
+            }
+            statsMutex.unlock();
+        }
+
+        if (timespecDiffNs(woke, tick) >= 0)
+        {
+            timespecAddNs(tick, ctx->tickNs);
+
+            // Fell behind: skip the missed ticks rather than bursting to catch up
+            int64_t behindNs = timespecDiffNs(woke, tick);
+            if (behindNs >= 0)
+            {
+                long missed = behindNs / ctx->tickNs + 1;
+                missedTicks += missed;
+                timespecAddNs(tick, missed * ctx->tickNs);
+            }
+        }
+    }
+    return nullptr;
+}
+
+static bool startKeyingThread(pthread_t &thread, KeyingContext &ctx, int priority)
+{
+    if (priority > 0)
+    {
+        pthread_attr_t attr;
+        struct sched_param param = {};
+        param.sched_priority = priority;
+        pthread_attr_init(&attr);
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        pthread_attr_setschedparam(&attr, &param);
+        int err = pthread_create(&thread, &attr, keyingThread, &ctx);
+        pthread_attr_destroy(&attr);
+        if (err == 0)
+        {
+            return true;
+        }
+        fprintf(stderr, "keyerd: SCHED_FIFO unavailable (%s), running at normal priority\n", strerror(err));
+    }
+    return pthread_create(&thread, nullptr, keyingThread, &ctx) == 0;
+}
+
+static void printStats(FILE *out)
+{
+    std::lock_guard<std::mutex> lock(statsMutex);
+    tickStats.print(out, "tick lateness");
+    edgeStats.print(out, "edge latency");
+    fprintf(out, "missed ticks: %llu\n", missedTicks.load());
+}
+
+static void handleLine(const std::string &line, FILE *reply)
+{
+    if (line.compare(0, 5, "/wpm ") == 0)
+    {
+        int wpm = atoi(line.c_str() + 5);
+        if (wpm < 5 || wpm > 40)
+        {
+            fprintf(reply, "ERR wpm must be 5-40\n");
+            return;
+        }
+        requestedWPM = wpm;
+        fprintf(reply, "OK\n");
+    }
+    else if (line == "/stats")
+    {
+        printStats(reply);
+    }
+    else if (line == "/reset")
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        tickStats.reset();
+        edgeStats.reset();
+        missedTicks.store(0);
+        fprintf(reply, "OK\n");
+    }
+    else if (!line.empty() && line[0] == '/')
+    {
+        fprintf(reply, "ERR unknown command\n");
+    }
+    else if (!line.empty())
+    {
+        std::lock_guard<std::mutex> lock(textMutex);
+        textQueue.push_back(line);
+        fprintf(reply, "OK\n");
+    }
+}
+
+// Reads with poll() so a client that stays connected cannot hold up shutdown.
+// Replies go out on their own stream, a single r+ stream would need a
+// flush or seek between every read and write.
+static void serveClient(int clientFd)
+{
+    int replyFd = dup(clientFd);
+    FILE *reply = replyFd >= 0 ? fdopen(replyFd, "w") : nullptr;
+    if (!reply)
+    {
+        if (replyFd >= 0)
+        {
+            close(replyFd);
+        }
+        close(clientFd);
+        return;
+    }
+    setvbuf(reply, nullptr, _IOLBF, 0);
+
+    std::string pending;
+    char buffer[512];
+    while (running)
+    {
+        struct pollfd pfd = {clientFd, POLLIN, 0};
+        int ready = poll(&pfd, 1, 200);
+        if (ready < 0 && errno != EINTR)
+        {
+            break;
+        }
+        if (ready <= 0)
+        {
+            continue;
+        }
+
+        ssize_t count = read(clientFd, buffer, sizeof(buffer));
+        if (count <= 0)
+        {
+            break;
+        }
+        pending.append(buffer, count);
+
+        size_t newline;
+        while ((newline = pending.find('\n')) != std::string::npos)
+        {
+            std::string line = pending.substr(0, newline);
+            pending.erase(0, newline + 1);
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+            handleLine(line, reply);
+        }
+    }
+    if (!pending.empty())
+    {
+        handleLine(pending, reply); // Last line without a newline
+    }
+    fclose(reply);
+    close(clientFd);
+}
+
+static int openSocket(const char *path)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    struct sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    unlink(path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 4) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static OutputSink *createSink(const char *spec)
+{
+    if (strncmp(spec, "file:", 5) == 0)
+    {
+        return new FileSink(spec + 5, KEYER_OUTPUT_PIN, KEYER_PTT_PIN);
+    }
+    if (strncmp(spec, "audio:", 6) == 0)
+    {
+        return new AudioSink(spec + 6, KEYER_OUTPUT_PIN, SIDETONE_FREQUENCY);
+    }
+    return nullptr;
+}
+
+static void usage()
+{
+    fprintf(stderr,
+            "usage: keyerd [-s socket] [-o file:PATH|audio:PATH] [-t tick_us] [-w wpm]\n"
+            "              [-r rt_priority] [-l ptt_lead_ms] [-g ptt_hang_ms]\n");
+}
+
+int main(int argc, char **argv)
+{
+    DaemonOptions options;
+    int opt;
+    while ((opt = getopt(argc, argv, "s:o:t:w:r:l:g:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 's': options.socketPath = optarg; break;
+        case 'o': options.sink = optarg; break;
+        case 't': options.tickUs = atol(optarg); break;
+        case 'w': options.wpm = atoi(optarg); break;
+        case 'r': options.rtPriority = atoi(optarg); break;
+        case 'l': options.pttLeadTime = atoi(optarg); break;
+        case 'g': options.pttHangTime = atoi(optarg); break;
+        default:
+            usage();
+            return 1;
+        }
+    }
+    if (options.tickUs <= 0)
+    {
+        usage();
+        return 1;
+    }
+
+    OutputSink *sink = createSink(options.sink);
+    if (!sink || !sink->open())
+    {
+        fprintf(stderr, "keyerd: cannot open sink '%s'\n", options.sink);
+        return 1;
+    }
+    halSetOutputSink(sink);
+
+    int listenFd = openSocket(options.socketPath);
+    if (listenFd < 0)
+    {
+        fprintf(stderr, "keyerd: cannot listen on %s: %s\n", options.socketPath, strerror(errno));
+        return 1;
+    }
+
+    struct sigaction action = {};
+    action.sa_handler = onSignal;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+    {
+        fprintf(stderr, "keyerd: mlockall failed (%s), page faults may add jitter\n", strerror(errno));
+    }
+
+    AD9833 toneGen(0, 0, 0);
+    KeyerConfig keyerConfig =
+    {
+        KEYER_DIT_PIN,
+        KEYER_DAH_PIN,
+        KEYER_OUTPUT_PIN,
+        KEYER_PTT_PIN,
+        KEYER_LED_PIN,
+        options.pttHangTime,
+        KEYER_SPEED_PIN,
+        options.pttLeadTime
+    };
+    Keyer keyer(keyerConfig, toneGen);
+    MorseCodeTranslator translator(keyer);
+
+    requestedWPM = options.wpm;
+    halSetAnalog(KEYER_SPEED_PIN, halAnalogForWPM(options.wpm));
+    keyer.setup();
+
+    KeyingContext ctx = {&keyer, &translator, sink, options.tickUs * 1000};
+    pthread_t thread;
+    if (!startKeyingThread(thread, ctx, options.rtPriority))
+    {
+        fprintf(stderr, "keyerd: cannot start keying thread\n");
+        return 1;
+    }
+
+    fprintf(stderr, "keyerd: listening on %s, tick %ldus\n", options.socketPath, options.tickUs);
+
+    while (running)
+    {
+        struct pollfd pfd = {listenFd, POLLIN, 0};
+        if (poll(&pfd, 1, 200) > 0)
+        {
+            int clientFd = accept(listenFd, nullptr, nullptr);
+            if (clientFd >= 0)
+            {
+                serveClient(clientFd);
+            }
+        }
+    }
+
+    pthread_join(thread, nullptr);
+    close(listenFd);
+    unlink(options.socketPath);
+    printStats(stderr);
+    halSetOutputSink(nullptr);
+    delete sink;
+    return 0;
+}
@@ -0,0 +1,498 @@
+/***********************************************************************
+ * File: test_keyercore.cpp
+ * Author: Dan Quigley, N7HQ
+ * Date: October 2026
+ *
+ * Description:
+ *     Model check of KeyerCore against a reference timing model. The
+ *     model is written from the keying rules (an element is followed
+ *     by an element space, a squeeze alternates, dit wins a squeeze
+ *     from rest, requests only start from idle, every deadline is
+ *     chained from the one before it) and shares no code with the
+ *     transition table.
+ *
+ *     Every reachable core state is found breadth first, and from each
+ *     one, with each paddle combination latched, every event (each
+ *     paddle combination, timer expiry and the four requests) is
+ *     applied at times before, at and well past the deadline. The next
+ *     state, key, wake time and transition time must match the model.
+ *     A long random walk across a micros() wrap follows.
+ *
+ *     The same inputs are then driven through Keyer, over every input
+ *     sequence up to SEQUENCE_DEPTH long, and the PTT invariant is
+ *     checked: no element is keyed before PTT has been up for the full
+ *     lead time, and PTT never drops while keyed.
+ ***********************************************************************/
+
+#include <deque>
+#include <string>
+
+#include "HostTest.h"
+
+#define RANDOM_EVENTS 200000
+#define SEQUENCE_DEPTH 3
+#define KEYER_WPM 40
+#define PTT_HANG_MS 50
+#define MAX_STEP_US 400
+
+static const char *const stateNames[CS_COUNT] = {
+    "IDLE", "DIT", "DAH", "IAMBIC_DIT", "IAMBIC_DAH",
+    "SPACE_AFTER_DIT", "SPACE_AFTER_DAH", "CHARACTER_SPACE", "WORD_SPACE"};
+static const char *const eventNames[] = {
+    "paddles", "timer", "request dit", "request dah", "request character space", "request word space"};
+static const char *const paddleNames[] = {"none", "dit", "dah", "both"};
+
+static unsigned long lcgState = 1;
+
+static unsigned long nextRandom(unsigned long range)
+{
+    lcgState = lcgState * 1103515245UL + 12345UL;
+    return (lcgState >> 8) % range;
+}
+
+/// @brief the keying rules, stated directly rather than as a table
+struct ReferenceKeyer
+{
+    enum Phase
+    {
+        REST,
+        ELEMENT,
+        ELEMENT_SPACE,
+        CHARACTER_SPACE,
+        WORD_SPACE
+    };
+
+    Phase phase = REST;
+    bool dahElement = false; // ELEMENT and ELEMENT_SPACE: the element sent
+    bool squeezed = false;   // ELEMENT: keyed while both paddles were held
+    bool dit = false;
+    bool dah = false;
+    unsigned long deadline = 0;
+    unsigned long lastTransition = 0;
+    unsigned long durations[KD_COUNT];
+
+    void begin(Phase next, unsigned long duration, unsigned long time)
+    {
+        phase = next;
+        deadline = time + duration;
+        lastTransition = time;
+    }
+
+    void key(bool isDah, bool isSqueezed, unsigned long time)
+    {
+        dahElement = isDah;
+        squeezed = isSqueezed;
+        begin(ELEMENT, durations[isDah ? KD_DAH : KD_DIT], time);
+    }
+
+    void rest(unsigned long time)
+    {
+        phase = REST;
+        lastTransition = time;
+    }
+
+    // From rest or the end of a character or word space the dit wins a squeeze
+    void keyFromRest(unsigned long time)
+    {
+        if (dit)
+        {
+            key(false, dah, time);
+        }
+        else if (dah)
+        {
+            key(true, false, time);
+        }
+        else
+        {
+            rest(time);
+        }
+    }
+
+    void expire()
+    {
+        unsigned long time = deadline;
+        switch (phase)
+        {
+        case ELEMENT:
+            begin(ELEMENT_SPACE, durations[KD_ELEMENT_SPACE], time);
+            break;
+        case ELEMENT_SPACE:
+            if (dit && dah)
+            {
+                key(!dahElement, true, time); // Squeeze alternates
+            }
+            else if (dit || dah)
+            {
+                key(dah, false, time); // A held paddle repeats its element
+            }
+            else
+            {
+                rest(time);
+            }
+            break;
+        default:
+            keyFromRest(time);
+            break;
+        }
+    }
+
+    bool handle(const KeyerEvent &event)
+    {
+        while (phase != REST && (long)(event.time - deadline) >= 0)
+        {
+            expire();
+        }
+
+        switch (event.type)
+        {
+        case KE_PADDLES:
+            dit = event.dit;
+            dah = event.dah;
+            if (phase == REST && (dit || dah))
+            {
+                keyFromRest(event.time);
+            }
+            return true;
+        case KE_TIMER:
+            return true;
+        default:
+            break;
+        }
+
+        if (phase != REST)
+        {
+            return false;
+        }
+        switch (event.type)
+        {
+        case KE_REQUEST_DIT:
+            key(false, false, event.time);
+            break;
+        case KE_REQUEST_DAH:
+            key(true, false, event.time);
+            break;
+        case KE_REQUEST_CHARACTER_SPACE:
+            begin(CHARACTER_SPACE, durations[KD_CHARACTER_SPACE], event.time);
+            break;
+        default:
+            begin(WORD_SPACE, durations[KD_WORD_SPACE], event.time);
+            break;
+        }
+        return true;
+    }
+
+    KeyerCoreState coreState() const
+    {
+        switch (phase)
+        {
+        case REST:
+            return CS_IDLE;
+        case ELEMENT:
+            if (squeezed)
+            {
+                return dahElement ? CS_IAMBIC_DAH : CS_IAMBIC_DIT;
+            }
+            return dahElement ? CS_DAH : CS_DIT;
+        case ELEMENT_SPACE:
+            return dahElement ? CS_SPACE_AFTER_DAH : CS_SPACE_AFTER_DIT;
+        case CHARACTER_SPACE:
+            return CS_CHARACTER_SPACE;
+        default:
+            return CS_WORD_SPACE;
+        }
+    }
+
+    KeyerState publicState() const
+    {
+        switch (phase)
+        {
+        case REST:
+            return IDLE;
+        case ELEMENT:
+            if (squeezed)
+            {
+                return dahElement ? IAMBIC_DAH : IAMBIC_DIT;
+            }
+            return dahElement ? TRANSMITTING_DAH : TRANSMITTING_DIT;
+        case ELEMENT_SPACE:
+            return WAITING_ELEMENT_SPACE;
+        case CHARACTER_SPACE:
+            return WAITING_CHARACTER_SPACE;
+        default:
+            return WAITING_WORD_SPACE;
+        }
+    }
+};
+
+/// @brief the core and the model after the same events
+struct ModelPair
+{
+    KeyerCore core;
+    ReferenceKeyer model;
+    unsigned long now;
+
+    ModelPair(const unsigned long *durations, unsigned long start) : now(start)
+    {
+        core.setTiming(durations[KD_DIT], durations[KD_DAH], durations[KD_ELEMENT_SPACE],
+                       durations[KD_CHARACTER_SPACE], durations[KD_WORD_SPACE]);
+        memcpy(model.durations, durations, sizeof(model.durations));
+    }
+
+    int key() const { return core.getCoreState() * 4 + (core.getDah() << 1) + core.getDit(); }
+
+    bool apply(const KeyerEvent &event, const char *context)
+    {
+        bool coreResult = core.handle(event);
+        bool modelResult = model.handle(event);
+        now = event.time;
+
+        unsigned long wake = 0;
+        bool hasWake = core.getNextWakeTime(wake);
+        bool modelHasWake = model.phase != ReferenceKeyer::REST;
+        unsigned long failures = testFailures;
+
+        CHECK(coreResult == modelResult, "%s: core returned %d, model %d", context, coreResult, modelResult);
+        CHECK(core.getCoreState() == model.coreState(), "%s: core went to %s, model to %s", context,
+              stateNames[core.getCoreState()], stateNames[model.coreState()]);
+        CHECK(core.getState() == model.publicState(), "%s: core reports state %d, model %d", context,
+              core.getState(), model.publicState());
+        CHECK(core.isKeyed() == (model.phase == ReferenceKeyer::ELEMENT), "%s: key %d, model %d", context,
+              core.isKeyed(), model.phase == ReferenceKeyer::ELEMENT);
+        CHECK(hasWake == modelHasWake && (!hasWake || wake == model.deadline),
+              "%s: core wakes %d at %lu, model %d at %lu", context, hasWake, wake, modelHasWake, model.deadline);
+        CHECK(core.getLastTransitionTime() == model.lastTransition, "%s: transition at %lu, model %lu", context,
+              core.getLastTransitionTime(), model.lastTransition);
+        CHECK(core.getDit() == model.dit && core.getDah() == model.dah, "%s: paddles differ", context);
+        return testFailures == failures;
+    }
+};
+
+static KeyerEvent makeEvent(int index, unsigned long time)
+{
+    // 0-3 paddle combinations, then timer and the requests
+    if (index < 4)
+    {
+        return {KE_PADDLES, time, (index & 1) != 0, (index & 2) != 0};
+    }
+    return {(KeyerEventType)(KE_TIMER + index - 4), time, false, false};
+}
+
+#define EVENT_COUNT 9
+
+// Every (state x paddles) the core can reach, every event, at several times
+static void checkExhaustive(const unsigned long *durations, unsigned long start)
+{
+    bool visited[CS_COUNT * 4] = {};
+    bool stateSeen[CS_COUNT] = {};
+    unsigned long transitions = 0;
+    std::deque<ModelPair> queue;
+
+    queue.push_back(ModelPair(durations, start));
+    visited[queue.front().key()] = true;
+
+    unsigned long longest = durations[KD_DAH] + durations[KD_ELEMENT_SPACE] + durations[KD_WORD_SPACE];
+    while (!queue.empty())
+    {
+        ModelPair from = queue.front();
+        queue.pop_front();
+        stateSeen[from.core.getCoreState()] = true;
+
+        unsigned long wake = from.now;
+        bool hasWake = from.core.getNextWakeTime(wake);
+        const unsigned long times[] = {from.now, wake - 1, wake, wake + longest, from.now + 1};
+        for (unsigned long time : times)
+        {
+            if ((long)(time - from.now) < 0 || (!hasWake && time == wake - 1))
+            {
+                continue;
+            }
+            for (int index = 0; index < EVENT_COUNT; index++)
+            {
+                KeyerEvent event = makeEvent(index, time);
+                char context[160];
+                snprintf(context, sizeof(context), "%s with %s held, %s%s%s at deadline%+ld (start %lu)",
+                         stateNames[from.core.getCoreState()], paddleNames[from.key() & 3], eventNames[event.type],
+                         event.type == KE_PADDLES ? " " : "", event.type == KE_PADDLES ? paddleNames[index] : "",
+                         (long)(time - wake), start);
+
+                ModelPair to = from;
+                transitions++;
+                if (to.apply(event, context) && !visited[to.key()])
+                {
+                    visited[to.key()] = true;
+                    queue.push_back(to);
+                }
+            }
+        }
+    }
+
+    for (int state = 0; state < CS_COUNT; state++)
+    {
+        CHECK(stateSeen[state], "%s never reached (start %lu)", stateNames[state], start);
+    }
+    CHECK(transitions > CS_COUNT * EVENT_COUNT, "only %lu transitions checked", transitions);
+}
+
+// Random events at random gaps, mostly near deadlines, across a micros() wrap
+static void checkRandomWalk(const unsigned long *durations, unsigned long start)
+{
+    ModelPair pair(durations, start);
+    bool wrapped = false;
+    for (unsigned long i = 0; i < RANDOM_EVENTS; i++)
+    {
+        unsigned long wake = pair.now;
+        unsigned long time;
+        switch (nextRandom(4))
+        {
+        case 0:
+            time = pair.now + nextRandom(durations[KD_DIT]);
+            break;
+        case 1:
+            time = pair.now + nextRandom(3 * durations[KD_WORD_SPACE]);
+            break;
+        default:
+            time = pair.core.getNextWakeTime(wake) ? wake + nextRandom(3) : pair.now;
+            break;
+        }
+
+        wrapped = wrapped || time < pair.now;
+        int index = nextRandom(EVENT_COUNT);
+        char context[96];
+        snprintf(context, sizeof(context), "random event %lu (%s at %lu)", i, eventNames[makeEvent(index, 0).type],
+                 time);
+        if (!pair.apply(makeEvent(index, time), context))
+        {
+            break;
+        }
+    }
+    CHECK(wrapped, "random walk did not cross the micros() wrap");
+}
+
+struct InputAction
+{
+    const char *name;
+    bool request;
+    KeyerEventType type; // request only
+    bool dit;            // paddles only
+    bool dah;
+    unsigned long holdUs;
+};
+
+static const InputAction inputActions[] = {
+    {"release 15 ms", false, KE_PADDLES, false, false, 15000},
+    {"release 150 ms", false, KE_PADDLES, false, false, 150000},
+    {"dit 15 ms", false, KE_PADDLES, true, false, 15000},
+    {"dit 150 ms", false, KE_PADDLES, true, false, 150000},
+    {"dah 15 ms", false, KE_PADDLES, false, true, 15000},
+    {"dah 150 ms", false, KE_PADDLES, false, true, 150000},
+    {"squeeze 15 ms", false, KE_PADDLES, true, true, 15000},
+    {"squeeze 150 ms", false, KE_PADDLES, true, true, 150000},
+    {"request dit", true, KE_REQUEST_DIT, false, false, 5000},
+    {"request dah", true, KE_REQUEST_DAH, false, false, 5000},
+    {"request character space", true, KE_REQUEST_CHARACTER_SPACE, false, false, 5000},
+    {"request word space", true, KE_REQUEST_WORD_SPACE, false, false, 5000},
+};
+
+#define INPUT_ACTION_COUNT (sizeof(inputActions) / sizeof(inputActions[0]))
+
+static void runFor(TestKeyer &test, unsigned long durationUs)
+{
+    for (unsigned long elapsed = 0; elapsed < durationUs;)
+    {
+        unsigned long stepUs = 1 + nextRandom(MAX_STEP_US);
+        test.step(stepUs);
+        elapsed += stepUs;
+    }
+}
+
+static void runSequence(const InputAction *const *sequence, int leadMs)
+{
+    TestKeyer test(KEYER_WPM, leadMs, PTT_HANG_MS);
+    std::string name;
+    for (int i = 0; i < SEQUENCE_DEPTH; i++)
+    {
+        const InputAction &action = *sequence[i];
+        name += (i ? ", " : "") + std::string(action.name);
+        if (action.request)
+        {
+            switch (action.type)
+            {
+            case KE_REQUEST_DIT:
+                test.keyer.triggerDit();
+                break;
+            case KE_REQUEST_DAH:
+                test.keyer.triggerDah();
+                break;
+            case KE_REQUEST_CHARACTER_SPACE:
+                test.keyer.sendCharacterSpace();
+                break;
+            default:
+                test.keyer.sendWordSpace();
+                break;
+            }
+        }
+        else
+        {
+            test.setPaddles(action.dit, action.dah);
+        }
+        runFor(test, action.holdUs);
+    }
+
+    // Release and run until back in receive, or a hard limit
+    test.setPaddles(false, false);
+    for (int i = 0; i < 100 && !(test.keyer.isReadyForInput() && digitalRead(TEST_PTT_PIN) == LOW); i++)
+    {
+        runFor(test, 10000);
+    }
+
+    char context[256];
+    snprintf(context, sizeof(context), "%s (lead %d ms)", name.c_str(), leadMs);
+    checkPttEdges(context, test.recorder.edges, leadMs * 1000UL);
+}
+
+// Every input sequence up to SEQUENCE_DEPTH long, at lead times shorter and longer than a space
+static void checkPttInvariant()
+{
+    const int leads[] = {0, 20, 100};
+    const InputAction *sequence[SEQUENCE_DEPTH];
+    unsigned long combinations = 1;
+    for (int i = 0; i < SEQUENCE_DEPTH; i++)
+    {
+        combinations *= INPUT_ACTION_COUNT;
+    }
+
+    for (int lead : leads)
+    {
+        for (unsigned long n = 0; n < combinations; n++)
+        {
+            unsigned long digits = n;
+            for (int i = 0; i < SEQUENCE_DEPTH; i++)
+            {
+                sequence[i] = &inputActions[digits % INPUT_ACTION_COUNT];
+                digits /= INPUT_ACTION_COUNT;
+            }
+            runSequence(sequence, lead);
+        }
+    }
+}
+
+int main()
+{
+    const unsigned long timings[][KD_COUNT] = {
+        {1, 3, 1, 3, 7},                          // shortest, deadlines one tick apart
+        {1009, 3011, 1103, 2999, 7001},           // distinct, a swapped duration shows
+        {60000, 180000, 60000, 144000, 504000},   // 20 WPM as Keyer sets it
+    };
+    const unsigned long starts[] = {TEST_START_TIME, (unsigned long)-2000L};
+
+    for (const unsigned long *durations : timings)
+    {
+        for (unsigned long start : starts)
+        {
+            checkExhaustive(durations, start);
+        }
+        checkRandomWalk(durations, (unsigned long)-(long)(RANDOM_EVENTS / 2 * durations[KD_DIT]));
+    }
+    checkPttInvariant();
+    return testResult("test_keyercore");
+}
@@ -0,0 +1,254 @@
+/***********************************************************************
+ * File: test_normalizer.cpp
+ * Author: Dan Quigley, N7HQ
+ * Date: October 2026
+ *
+ * Description:
+ *     Property tests for MorseInputNormalizer over every morseMap and
+ *     prosignMap entry. Each entry is sent in upper and lower case as
+ *     UTF-8, wrapped in random input that must be dropped (stray or
+ *     truncated UTF-8, overlong forms, characters with no Morse), and
+ *     must come out as exactly its own token. Random text must round
+ *     trip, and fixed cases cover line ends and stray '<'.
+ ***********************************************************************/
+
+#include <string>
+
+#include "HostTest.h"
+
+#define RANDOM_TRIALS 200
+
+static unsigned long lcgState = 1;
+
+static unsigned long nextRandom(unsigned long range)
+{
+    lcgState = lcgState * 1103515245UL + 12345UL;
+    return (lcgState >> 8) % range;
+}
+
+static std::string utf8(uint32_t c)
+{
+    std::string out;
+    if (c < 0x80)
+    {
+        out += (char)c;
+    }
+    else
+    {
+        out += (char)(0xC0 | (c >> 6));
+        out += (char)(0x80 | (c & 0x3F));
+    }
+    return out;
+}
+
+static std::vector<uint8_t> normalize(const std::string &input)
+{
+    MorseInputNormalizer normalizer;
+    std::vector<uint8_t> tokens;
+    for (unsigned char byte : input)
+    {
+        uint8_t out[MORSE_MAX_TOKENS_PER_BYTE];
+        uint8_t count = normalizer.push(byte, out);
+        CHECK(count <= MORSE_MAX_TOKENS_PER_BYTE, "%u tokens from one byte", count);
+        tokens.insert(tokens.end(), out, out + count);
+    }
+    return tokens;
+}
+
+static std::string describe(const std::string &input)
+{
+    std::string out;
+    char hex[8];
+    for (unsigned char byte : input)
+    {
+        if (byte >= 0x20 && byte < 0x7F)
+        {
+            out += (char)byte;
+        }
+        else
+        {
+            snprintf(hex, sizeof(hex), "\\x%02X", byte);
+            out += hex;
+        }
+    }
+    return out;
+}
+
+static std::string tokenString(const std::vector<uint8_t> &tokens)
+{
+    std::string out;
+    for (uint8_t token : tokens)
+    {
+        if (token == MORSE_TOKEN_WORD_SPACE)
+        {
+            out += '_';
+        }
+        else if (token < MorseCodeTranslator::morseMapSize)
+        {
+            out += MorseCodeTranslator::morseMap[token].character;
+        }
+        else
+        {
+            out += '<';
+            out += MorseCodeTranslator::prosignMap[token - MorseCodeTranslator::morseMapSize].name;
+            out += '>';
+        }
+    }
+    return out;
+}
+
+// Input that must produce no token when followed by a character
+static std::string noise()
+{
+    static const char *const junk[] = {
+        "\x80", "\xBF",                 // stray continuation bytes
+        "\xC1\x81", "\xC0\xA0",         // overlong 'A' and ' '
+        "\xE0\x81\x81",                 // overlong 3-byte 'A'
+        "\xF0\x80\x81\x81",             // overlong 4-byte 'A'
+        "\xED\xA0\x80",                 // UTF-16 surrogate
+        "\xF4\x90\x80\x80",             // past U+10FFFF
+        "\xF8", "\xFF",                 // invalid lead bytes
+        "\xE2\x82\xAC",                 // U+20AC, no table entry
+        "#", "\t", "<XY>", "<>",        // no Morse, unknown prosigns
+    };
+    // Truncated sequences only come last, a continuation byte after one would complete it
+    static const char *const truncated[] = {"", "\xC3", "\xE2\x82", "\xF0\x9F"};
+    std::string out;
+    unsigned long count = nextRandom(4);
+    for (unsigned long i = 0; i < count; i++)
+    {
+        out += junk[nextRandom(sizeof(junk) / sizeof(junk[0]))];
+    }
+    return out + truncated[nextRandom(sizeof(truncated) / sizeof(truncated[0]))];
+}
+
+static bool hasLowerCase(uint8_t c)
+{
+    return (c >= 'A' && c <= 'Z') || (c >= 0xC0 && c <= 0xDE && c != 0xD7);
+}
+
+static void checkEveryCharacter()
+{
+    for (int i = 0; i < MorseCodeTranslator::morseMapSize; i++)
+    {
+        uint8_t c = MorseCodeTranslator::morseMap[i].character;
+        uint8_t expected;
+        CHECK(MorseInputNormalizer::lookupCharacter(c, expected), "morseMap[%d] not found", i);
+        CHECK(strcmp(MorseCodeTranslator::morseMap[expected].code, MorseCodeTranslator::morseMap[i].code) == 0,
+              "morseMap[%d] shadowed by morseMap[%d]", i, expected);
+
+        for (int lower = 0; lower < 2; lower++)
+        {
+            if (lower && !hasLowerCase(c))
+            {
+                continue;
+            }
+            for (int trial = 0; trial < RANDOM_TRIALS; trial++)
+            {
+                std::string input = noise() + utf8(lower ? c + 0x20 : c) + noise();
+                std::vector<uint8_t> tokens = normalize(input);
+                CHECK(tokens.size() == 1 && tokens[0] == expected, "'%s' gave '%s', expected morseMap[%d]",
+                      describe(input).c_str(), tokenString(tokens).c_str(), expected);
+            }
+        }
+    }
+}
+
+static void checkEveryProsign()
+{
+    for (int i = 0; i < MorseCodeTranslator::prosignMapSize; i++)
+    {
+        for (int lower = 0; lower < 2; lower++)
+        {
+            std::string name = MorseCodeTranslator::prosignMap[i].name;
+            for (char &c : name)
+            {
+                c = lower ? c + 0x20 : c;
+            }
+            for (int trial = 0; trial < RANDOM_TRIALS; trial++)
+            {
+                std::string input = noise() + "<" + name + ">" + noise();
+                std::vector<uint8_t> tokens = normalize(input);
+                CHECK(tokens.size() == 1 && tokens[0] == MorseCodeTranslator::morseMapSize + i,
+                      "'%s' gave '%s'", describe(input).c_str(), tokenString(tokens).c_str());
+            }
+        }
+    }
+}
+
+// Random text from table characters and spaces comes out unchanged, upper-cased
+static void checkRoundTrip()
+{
+    for (int trial = 0; trial < RANDOM_TRIALS * 10; trial++)
+    {
+        std::string input;
+        std::string expected;
+        unsigned long length = 1 + nextRandom(40);
+        for (unsigned long i = 0; i < length; i++)
+        {
+            if (nextRandom(6) == 0)
+            {
+                input += ' ';
+                expected += '_';
+                continue;
+            }
+            uint8_t c = MorseCodeTranslator::morseMap[nextRandom(MorseCodeTranslator::morseMapSize)].character;
+            bool lower = hasLowerCase(c) && nextRandom(2);
+            input += utf8(lower ? c + 0x20 : c);
+            expected += (char)c;
+        }
+        std::vector<uint8_t> tokens = normalize(input);
+        CHECK(tokenString(tokens) == expected, "'%s' gave '%s'", describe(input).c_str(), tokenString(tokens).c_str());
+        CHECK(tokens.size() <= input.size(), "more tokens than bytes for '%s'", describe(input).c_str());
+    }
+}
+
+static void checkCase(const std::string &input, const char *expected)
+{
+    std::string actual = tokenString(normalize(input));
+    CHECK(actual == expected, "'%s' gave '%s', expected '%s'", describe(input).c_str(), actual.c_str(), expected);
+}
+
+static void checkFixedCases()
+{
+    checkCase("CQ\nDE\n", "CQ_DE_");
+    checkCase("CQ\r\nDE\r\n", "CQ_DE_");
+    checkCase("CQ \n\n\nDE", "CQ_DE");
+    checkCase("\n\nCQ", "CQ");
+    checkCase(" CQ", "_CQ");
+    checkCase("A  B", "A__B");
+    checkCase("A < B OK", "A__B_OK");
+    checkCase("<AR", "");
+    checkCase("<AR\n", "AR_");
+    checkCase("<AR <SK>", "AR_<SK>");
+    checkCase("<A1>", "A1");
+    checkCase("<ABCD", "ABCD");
+    checkCase("<<AR>", "<AR>");
+    checkCase("E<AR>E", "E<AR>E");
+    checkCase("\xC1\x81\xC0\xA0" "E", "E");
+}
+
+// The translator never takes more bytes than it has queue for, even with letters held for a prosign
+static void checkTranslatorQueue()
+{
+    TestKeyer test(20, 0, 0);
+    for (int trial = 0; trial < RANDOM_TRIALS * 10; trial++)
+    {
+        static const char alphabet[] = "AB<>R \n";
+        uint8_t byte = alphabet[nextRandom(sizeof(alphabet) - 1)];
+        int available = test.translator.availableForWrite();
+        CHECK(available >= 0 && available <= TRANSLATOR_QUEUE_SIZE, "availableForWrite() = %d", available);
+        size_t accepted = test.translator.write(byte);
+        CHECK(accepted == (available > 0 ? 1u : 0u), "write() = %zu with %d available", accepted, available);
+    }
+}
+
+int main()
+{
+    checkEveryCharacter();
+    checkEveryProsign();
+    checkRoundTrip();
+    checkFixedCases();
+    checkTranslatorQueue();
+    return testResult("test_normalizer");
+}
@@ -0,0 +1,172 @@
+/***********************************************************************
+ * File: test_ptt.cpp
+ * Author: Dan Quigley, N7HQ
+ * Date: October 2026
+ *
+ * Description:
+ *     Checks the PTT sequencing invariant: no element is ever keyed
+ *     before PTT has been up for the full lead time, and PTT never
+ *     drops while the key is down. Paddle and translator input are
+ *     mixed at several speeds, lead times and loop rates, including a
+ *     start just before micros() wraps, and a tap shorter than the lead
+ *     time after the last transition has aged past LONG_MAX.
+ ***********************************************************************/
+
+#include <climits>
+
+#include "HostTest.h"
+
+enum ActionType
+{
+    PADDLES,
+    TEXT
+};
+
+struct Action
+{
+    unsigned long at; // us after the start
+    ActionType type;
+    bool dit;
+    bool dah;
+    const char *text;
+};
+
+struct Scenario
+{
+    const char *name;
+    std::vector<Action> actions;
+};
+
+static unsigned long lcgState = 1;
+
+static unsigned long nextStep(unsigned long maxStepUs)
+{
+    lcgState = lcgState * 1103515245UL + 12345UL;
+    return 1 + (lcgState >> 8) % maxStepUs;
+}
+
+static void runScenario(const Scenario &scenario, int wpm, int leadMs, unsigned long maxStepUs,
+                        unsigned long startTime)
+{
+    const int hangMs = 50;
+    TestKeyer test(wpm, leadMs, hangMs, startTime);
+    size_t next = 0;
+    unsigned long elapsed = 0;
+    unsigned long lastAction = scenario.actions.back().at;
+
+    // Run until all input is sent and PTT has dropped, or a hard limit
+    while (elapsed < lastAction + 30000000UL)
+    {
+        if (elapsed > lastAction && test.translator.isReadyForText() && test.keyer.isReadyForInput() &&
+            digitalRead(TEST_PTT_PIN) == LOW)
+        {
+            break;
+        }
+        while (next < scenario.actions.size() && scenario.actions[next].at <= elapsed)
+        {
+            const Action &action = scenario.actions[next++];
+            if (action.type == PADDLES)
+            {
+                test.setPaddles(action.dit, action.dah);
+            }
+            else
+            {
+                test.translator.setText(action.text);
+            }
+        }
+        unsigned long stepUs = nextStep(maxStepUs);
+        test.step(stepUs);
+        elapsed += stepUs;
+    }
+
+    char name[128];
+    snprintf(name, sizeof(name), "%s (%d WPM, lead %d ms, step <= %lu us, start %lu)",
+             scenario.name, wpm, leadMs, maxStepUs, startTime);
+    int keyDowns = checkPttEdges(name, test.recorder.edges, leadMs * 1000UL);
+    CHECK(keyDowns > 0, "%s: nothing was keyed", name);
+}
+
+// A tap shorter than the lead time never reaches the core, so its last transition
+// can be more than LONG_MAX us old. PTT must still drop one hang time after it settles.
+static void checkTapAfterLongIdle(int leadMs, bool keyedBefore)
+{
+    const int hangMs = 50;
+    TestKeyer test(20, leadMs, hangMs);
+    if (keyedBefore)
+    {
+        test.setPaddles(true, false);
+        test.run(700000, 100);
+        test.setPaddles(false, false);
+        test.run(1000000, 100);
+    }
+    halAdvanceClock((unsigned long)LONG_MAX + 1000000UL);
+
+    test.setPaddles(true, false);
+    test.run(5000, 100);
+    test.setPaddles(false, false);
+
+    char name[96];
+    snprintf(name, sizeof(name), "tap after long idle (lead %d ms%s)", leadMs, keyedBefore ? ", keyed before" : "");
+    CHECK(digitalRead(TEST_PTT_PIN) == HIGH, "%s: tap did not raise PTT", name);
+
+    // Once PTT has settled the reported event is the drop, one hang time away
+    unsigned long dropBy = micros() + (leadMs + hangMs) * 1000UL;
+    test.run(leadMs * 1000UL, 100);
+    unsigned long eventTime = 0;
+    CHECK(test.keyer.getNextEventTime(eventTime) && (long)(eventTime - micros()) >= 0 &&
+              (long)(eventTime - dropBy) <= 0,
+          "%s: next event %ld us away, PTT should drop within %d ms", name, (long)(eventTime - micros()), hangMs);
+    while ((long)(micros() - dropBy) < 0)
+    {
+        test.step(100);
+    }
+    test.step(100);
+    CHECK(digitalRead(TEST_PTT_PIN) == LOW, "%s: PTT still up %d ms after the tap", name, leadMs + hangMs);
+    checkPttEdges(name, test.recorder.edges, leadMs * 1000UL);
+}
+
+int main()
+{
+    const std::vector<Scenario> scenarios = {
+        // Paddles are held past the longest lead time so something is always keyed
+        {"dit paddle", {{0, PADDLES, true, false}, {700000, PADDLES, false, false}}},
+        {"dah paddle", {{0, PADDLES, false, true}, {700000, PADDLES, false, false}}},
+        {"squeeze", {{0, PADDLES, true, true}, {2500000, PADDLES, false, false}}},
+        {"text", {{0, TEXT, false, false, "PARIS"}}},
+        {"text then paddle", {{0, TEXT, false, false, "E"}, {20000, PADDLES, true, false}, {900000, PADDLES, false, false}}},
+        {"space then dit held", {{0, TEXT, false, false, " "}, {1000, PADDLES, true, false}, {2500000, PADDLES, false, false}}},
+        {"space then squeeze", {{0, TEXT, false, false, " "}, {0, PADDLES, true, true}, {2500000, PADDLES, false, false}}},
+        {"paddle after PTT drop", {{0, PADDLES, true, false}, {450000, PADDLES, false, false},
+                                   {1500000, PADDLES, false, true}, {2100000, PADDLES, false, false}}},
+    };
+    const int speeds[] = {10, 20, 40};
+    const int leads[] = {0, 15, 400};
+    const unsigned long maxSteps[] = {10, 300, 2000};
+    const unsigned long starts[] = {TEST_START_TIME, (unsigned long)-300000L};
+
+    for (const Scenario &scenario : scenarios)
+    {
+        for (int wpm : speeds)
+        {
+            for (int lead : leads)
+            {
+                for (unsigned long maxStep : maxSteps)
+                {
+                    for (unsigned long start : starts)
+                    {
+                        runScenario(scenario, wpm, lead, maxStep, start);
+                    }
+                }
+            }
+        }
+    }
+    for (int lead : leads)
+    {
+        if (lead > 5)
+        {
+            checkTapAfterLongIdle(lead, false);
+            checkTapAfterLongIdle(lead, true);
+        }
+    }
+    return testResult("test_ptt");
+}
@@ -0,0 +1,166 @@
+/***********************************************************************
+ * File: test_scheduler.cpp
+ * Author: Dan Quigley, N7HQ
+ * Date: October 2026
+ *
+ * Description:
+ *     Deterministic edge lateness test for LoopScheduler. On the
+ *     simulated clock every task advances micros() by its cost, so a
+ *     run is exactly repeatable. Text is sent while a slow serial parse
+ *     and an ADC read compete for the loop, and every output edge is
+ *     measured from the keyer deadline that led to it, including the
+ *     elements the translator starts when a space ends.
+ *
+ *     With LoopScheduler no edge may be later than one keying pass.
+ *     The same load in a plain round robin loop must delay some edge by
+ *     at least half the parse task, so the test also shows the load is
+ *     heavy enough to matter.
+ ***********************************************************************/
+
+#include "HostTest.h"
+#include "../LoopScheduler.h"
+
+#define KEYING_COST 20 // us per keying pass
+#define PARSE_PERIOD 3000
+#define PARSE_COST 800
+#define ADC_PERIOD 1000
+#define ADC_COST 120
+#define RUN_TIME 20000000UL // us of simulated time per case
+
+static TestKeyer *test = nullptr;
+static const char *text = nullptr;
+static bool edgeDue = false;
+static unsigned long dueEdge = 0;
+static unsigned long edges = 0;
+static long maxLateness = 0;
+
+// micros() only moves between tasks here, so a deadline due before update() is
+// the one update() handles, and it can be held until the edge it leads to. That
+// also catches a translator that starts the next element passes later. On the
+// real clock keyerbench attributes an edge only within its own pass instead.
+static void keyingTask()
+{
+    unsigned long edge;
+    if (test->keyer.getNextEventTime(edge) && (long)(micros() - edge) >= 0)
+    {
+        edgeDue = true;
+        dueEdge = edge;
+    }
+
+    int keyBefore = digitalRead(TEST_OUTPUT_PIN);
+    test->keyer.update();
+    if (test->translator.isReadyForText())
+    {
+        test->translator.setText(text);
+    }
+    test->translator.update();
+
+    if (edgeDue && digitalRead(TEST_OUTPUT_PIN) != keyBefore)
+    {
+        long lateness = (long)(halPinChangeTime(TEST_OUTPUT_PIN) - dueEdge);
+        maxLateness = max(maxLateness, lateness);
+        edges++;
+        edgeDue = false;
+    }
+    else if (test->translator.isReadyForText())
+    {
+        edgeDue = false; // Nothing left to key from that deadline
+    }
+    halAdvanceClock(KEYING_COST);
+}
+
+static void parseTask()
+{
+    halAdvanceClock(PARSE_COST);
+}
+
+static void adcTask()
+{
+    halAdvanceClock(ADC_COST);
+}
+
+/// @brief sends text under load for RUN_TIME, returns the latest edge in us
+static long runCase(const char *message, int wpm, int leadMs, bool scheduled, bool withAdc,
+                    unsigned long *keyingLateness)
+{
+    TestKeyer keyer(wpm, leadMs, 250);
+    test = &keyer;
+    text = message;
+    edgeDue = false;
+    edges = 0;
+    maxLateness = 0;
+
+    LoopScheduler scheduler(keyer.keyer);
+    scheduler.setKeyingTask(keyingTask, KEYING_COST);
+    scheduler.addTask("parse", parseTask, PARSE_PERIOD, PARSE_COST);
+    if (withAdc)
+    {
+        scheduler.addTask("adc", adcTask, ADC_PERIOD, ADC_COST);
+    }
+
+    unsigned long start = micros();
+    unsigned long nextParse = start;
+    unsigned long nextAdc = start;
+    while (micros() - start < RUN_TIME)
+    {
+        if (scheduled)
+        {
+            scheduler.run();
+            continue;
+        }
+
+        keyingTask();
+        if ((long)(micros() - nextParse) >= 0)
+        {
+            nextParse += PARSE_PERIOD;
+            parseTask();
+        }
+        if (withAdc && (long)(micros() - nextAdc) >= 0)
+        {
+            nextAdc += ADC_PERIOD;
+            adcTask();
+        }
+    }
+
+    CHECK(edges >= 20, "'%s' at %d WPM keyed only %lu edges", message, wpm, edges);
+    if (keyingLateness)
+    {
+        *keyingLateness = scheduler.getKeyingTask().maxLateness;
+    }
+    test = nullptr;
+    return maxLateness;
+}
+
+int main()
+{
+    const char *const messages[] = {"EEEEE", "PARIS PARIS", "<AR> 73 <SK>"};
+    const int speeds[] = {5, 20, 40};
+    const int leads[] = {0, 15};
+    long roundRobinWorst = 0;
+
+    for (const char *message : messages)
+    {
+        for (int wpm : speeds)
+        {
+            for (int lead : leads)
+            {
+                for (int withAdc = 0; withAdc < 2; withAdc++)
+                {
+                    unsigned long keyingLateness = 0;
+                    long scheduled = runCase(message, wpm, lead, true, withAdc, &keyingLateness);
+                    CHECK(scheduled < KEYING_COST,
+                          "'%s' %d WPM lead %d adc %d: scheduled edge %ld us late, bound is %d us",
+                          message, wpm, lead, withAdc, scheduled, KEYING_COST);
+                    CHECK(keyingLateness < KEYING_COST, "keying task started %lu us after its edge",
+                          keyingLateness);
+
+                    long roundRobin = runCase(message, wpm, lead, false, withAdc, nullptr);
+                    roundRobinWorst = max(roundRobinWorst, roundRobin);
+                }
+            }
+        }
+    }
+    CHECK(roundRobinWorst >= PARSE_COST / 2, "round robin edges at most %ld us late, load is too light to test",
+          roundRobinWorst);
+    return testResult("test_scheduler");
+}
@@ -33,8 +33,19 @@
 
 #include "Keyer.h"
 #include "MorseCodeTranslator.h"
+#include "LoopScheduler.h"
 
 #define SERIAL_BAUD 115200
+#define SERIAL_CHUNK 16     // max bytes taken from Serial per task run, 16 per ms keeps ahead of 115200 baud
+
+// Background task periods and budgets (us), see LoopScheduler.h
+#define KEYING_TASK_BUDGET 100
+#define SERIAL_TASK_PERIOD 1000
+#define SERIAL_TASK_BUDGET 400
+#define SPEED_TASK_PERIOD 20000
+#define SPEED_TASK_BUDGET 150
+#define STATS_TASK_PERIOD 10000000
+#define STATS_TASK_BUDGET 5000
 
 #define KEYER_DIT_PIN 3     // pin for DIT
 #define KEYER_DAH_PIN 2     // pin for DAH
@@ -42,6 +53,7 @@
 #define KEYER_LED_PIN LED_BUILTIN
 #define KEYER_PTT_PIN 5
 #define KEYER_PTT_HANG_TIME 250 // in ms
+#define KEYER_PTT_LEAD_TIME 15  // in ms, relay/amp settle time before first element
 
 #define KEYER_SPEED_PIN A0  // wpm wiper (analog) pin
 
@@ -50,7 +62,11 @@
 #define AD9833_CLK_PIN 11
 #define AD9833_DATA_PIN 12
 
+#ifdef PWM_SIDETONE
+PwmSidetone ToneGen; // sidetone on SIDETONE_PWM_PIN, AD9833 pins unused
+#else
 AD9833 ToneGen(AD9833_FSYNC_PIN, AD9833_CLK_PIN, AD9833_DATA_PIN);
+#endif
 
 KeyerConfig keyerConfig = 
 {
@@ -60,28 +76,114 @@ KeyerConfig keyerConfig =
   KEYER_PTT_PIN, 
   KEYER_LED_PIN,
   KEYER_PTT_HANG_TIME,
-  KEYER_SPEED_PIN
+  KEYER_SPEED_PIN,
+  KEYER_PTT_LEAD_TIME
 }; 
 
 Keyer keyer(keyerConfig, ToneGen);
 MorseCodeTranslator translator(keyer);
+LoopScheduler scheduler(keyer);
+
+// Time critical: the translator keys the next element as soon as the keyer is idle
+void keyingTask()
+{
+  keyer.update();
+  translator.update();
+}
+
+bool discardingLine = false;
+bool lineEndPending = false;
+unsigned int discardedBytes = 0;
+
+// Stream bytes straight into the translator, no blocking line read. Text can run
+// at most TRANSLATOR_QUEUE_SIZE symbols ahead of the keyer; past that the rest of
+// the line is discarded with a message instead of overflowing the Serial buffer.
+// A line end that finds the queue full waits for room rather than being dropped,
+// so the next line still starts a new word.
+void serialTask()
+{
+  if (lineEndPending)
+  {
+    if (translator.availableForWrite() <= 0)
+    {
+      return; // Leave the next line in the Serial buffer until the word space is in
+    }
+    translator.write('\n');
+    lineEndPending = false;
+  }
+
+  for (uint8_t i = 0; i < SERIAL_CHUNK && Serial.available() > 0; i++)
+  {
+    if (!discardingLine && translator.availableForWrite() > 0)
+    {
+      translator.write(Serial.read());
+      continue;
+    }
+
+    int c = Serial.read();
+    if (c != '\n' && c != '\r')
+    {
+      discardingLine = true;
+      discardedBytes++;
+      continue;
+    }
+
+    if (discardedBytes > 0)
+    {
+      Serial.print(F("Line too long, dropped "));
+      Serial.print(discardedBytes);
+      Serial.println(F(" bytes"));
+    }
+    discardingLine = false;
+    discardedBytes = 0;
+
+    if (translator.availableForWrite() <= 0)
+    {
+      lineEndPending = true;
+      return;
+    }
+    translator.write('\n'); // Keep the next line a separate word, CR LF merges into one
+  }
+}
+
+void speedTask()
+{
+  keyer.updateWPM(); // analogRead() takes ~110us
+}
+
+#ifdef DEBUG_OUTPUT
+void statsTask()
+{
+  char line[80];
+  const LoopTask &keying = scheduler.getKeyingTask();
+  sprintf(line, "%-8s runs=%lu max=%luus late=%luus over=%lu", keying.name,
+          keying.runs, keying.maxRunTime, keying.maxLateness, keying.overruns);
+  Serial.println(line);
+  for (uint8_t i = 0; i < scheduler.getTaskCount(); i++)
+  {
+    const LoopTask &task = scheduler.getTask(i);
+    sprintf(line, "%-8s runs=%lu max=%luus late=%luus over=%lu", task.name,
+            task.runs, task.maxRunTime, task.maxLateness, task.overruns);
+    Serial.println(line);
+  }
+}
+#endif
 
 void setup()
 {
   Serial.begin(SERIAL_BAUD);
   Serial.println(__FILE__);
   keyer.setup();
+
+  scheduler.setKeyingTask(keyingTask, KEYING_TASK_BUDGET);
+  scheduler.addTask("serial", serialTask, SERIAL_TASK_PERIOD, SERIAL_TASK_BUDGET);
+  scheduler.addTask("speed", speedTask, SPEED_TASK_PERIOD, SPEED_TASK_BUDGET);
+#ifdef DEBUG_OUTPUT
+  scheduler.addTask("stats", statsTask, STATS_TASK_PERIOD, STATS_TASK_BUDGET);
+#endif
 }
 
 void loop()
 {
-  keyer.update();
-
-  if (Serial.available() > 0)
-  {
-    String input = Serial.readStringUntil('\n');
-    translator.setText(input);
-  }
-
-  translator.update();
+  scheduler.run();
 }